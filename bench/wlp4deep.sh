@@ -0,0 +1,53 @@
+#!/bin/sh
+# Stress test for deep parse trees: builds the four stages, generates each
+# program kind below with wlp4programs.py and runs it through
+# scan | parse | type | gen under the default 8 MB stack. Prints the time
+# of each stage and exits 1 if any stage fails, as a stage that still
+# recursed over the tree would with a segfault.
+#
+# usage: bench/wlp4deep.sh [BUILD_DIR]
+#
+# The stages are built into BUILD_DIR (a temporary directory by default)
+# with $CXX (g++) and $CXXFLAGS (-O2). Set SCALE to a fraction such as 0.1
+# for a quicker run on smaller programs.
+set -u
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BUILD=${1:-$(mktemp -d)}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+SCALE=${SCALE:-1}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$BUILD" || exit 1
+for stage in scanner/wlp4scan.cpp parse/wlp4parse.cc type/wlp4type.cc codegen/wlp4gen.cc; do
+  name=$(basename "${stage%.*}")
+  echo "building $name"
+  $CXX -std=c++20 $CXXFLAGS -pthread -o "$BUILD/$name" "$ROOT/$stage" || exit 1
+done
+
+ulimit -s 8192
+now() { date +%s%N; }
+failed=0
+for case in stmts:200000 parens:50000 chain:100000 nest:20000 dcls:100000 procs:20000 args:10000; do
+  kind=${case%%:*}
+  n=$(awk "BEGIN { n = int(${case#*:} * $SCALE); print (n > 0 ? n : 1) }")
+  python3 "$ROOT/bench/wlp4programs.py" "$kind" "$n" > "$WORK/in.wlp4" || exit 1
+  line=$(printf '%-7s %7d' "$kind" "$n")
+  input="$WORK/in.wlp4"
+  for stage in wlp4scan wlp4parse wlp4type wlp4gen; do
+    start=$(now)
+    "$BUILD/$stage" < "$input" > "$WORK/$stage.out" 2> "$WORK/$stage.err"
+    rc=$?
+    end=$(now)
+    if [ $rc -ne 0 ] || [ -s "$WORK/$stage.err" ] || [ ! -s "$WORK/$stage.out" ]; then
+      line="$line  $stage FAILED (rc $rc) $(head -c 60 "$WORK/$stage.err")"
+      failed=1
+      break
+    fi
+    line="$line  ${stage#wlp4} $(awk "BEGIN { printf \"%.2f s\", ($end - $start) / 1e9 }")"
+    input="$WORK/$stage.out"
+  done
+  echo "$line"
+done
+exit $failed
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# Generates WLP4 inputs for the benchmarks.
+#
+# usage: wlp4programs.py KIND N > out.wlp4
+#
+#   program N   N procedures that each call the one before, then wain; a
+#               valid program of short statements with 2-space indentation
+#               (N = 20000 gives about 30 MB)
+#   tokens N    N lines of long identifiers, ten-digit numbers and deep,
+#               varying indentation; scans, but does not parse
+#               (N = 150000 gives about 18 MB)
+#
+# and programs whose parse trees are as deep as they are long:
+#
+#   stmts N     N statements in wain
+#   parens N    an expression in N nested parentheses
+#   chain N     a sum of N + 1 terms
+#   nest N      N nested if statements
+#   dcls N      N declarations in wain
+#   args N      a procedure with N parameters, called with N arguments
+#   procs N     N procedures
+import random
+import sys
+
+
+def program(n, out):
+    for i in range(n):
+        out('// procedure number %d computes stuff\n' % i)
+        out('int procedureWithALongName%d(int argumentNumberOne, int* argumentPointer) {\n' % i)
+        out('  int localVariableAccumulator = 12345;\n  int anotherLocal = 0;\n')
+        for k in range(5):
+            out('  localVariableAccumulator = localVariableAccumulator + argumentNumberOne * %d'
+                ' - (anotherLocal %% 7);\n' % (k + 1))
+            out('  if (localVariableAccumulator > 1000000) { localVariableAccumulator ='
+                ' localVariableAccumulator / 3; } else { anotherLocal = anotherLocal + 1; }\n')
+        if i > 0:
+            out('  anotherLocal = procedureWithALongName%d(argumentNumberOne - 1, argumentPointer);\n'
+                % (i - 1))
+        out('  return localVariableAccumulator + anotherLocal;\n}\n')
+    out('int wain(int a, int b) {\n  int* p = NULL;\n  int r = 0;\n')
+    if n > 0:
+        out('  r = procedureWithALongName%d(a, p);\n' % (n - 1))
+    out('  println(r);\n  while (b > 0) { r = r - b; b = b - 1; }\n  return r;\n}\n')
+
+
+def tokens(n, out):
+    rng = random.Random(1)
+    for i in range(n):
+        out(' ' * rng.randrange(40))
+        out('someRatherLongGeneratedIdentifierName%d = anotherGeneratedIdentifierWithSuffix%d + %d;\n'
+            % (i, i * 7, rng.randrange(10 ** 9, 2 ** 31)))
+
+
+def stmts(n, out):
+    out('int wain(int a, int b) {\n  int x = 0;\n' + '  x = x + 1;\n' * n + '  return x;\n}\n')
+
+
+def parens(n, out):
+    out('int wain(int a, int b) {\n  int x = 1;\n  x = ' + '(' * n + 'x' + ')' * n +
+        ';\n  return x;\n}\n')
+
+
+def chain(n, out):
+    out('int wain(int a, int b) {\n  int x = 1;\n  x = x' + ' + a' * n + ';\n  return x;\n}\n')
+
+
+def nest(n, out):
+    out('int wain(int a, int b) {\n  int x = 0;\n' + '  if (x < 1) {\n' * n + '  x = x + 1;\n' +
+        '  } else {}\n' * n + '  return x;\n}\n')
+
+
+def dcls(n, out):
+    out('int wain(int a, int b) {\n')
+    for i in range(n):
+        out('  int v%d = %d;\n' % (i, i))
+    out('  return v%d;\n}\n' % (n - 1))
+
+
+def args(n, out):
+    out('int f(%s) {\n  return p0 + p%d;\n}\n' % (', '.join('int p%d' % i for i in range(n)), n - 1))
+    out('int wain(int a, int b) {\n  return f(%s);\n}\n' % ', '.join(['a'] * n))
+
+
+def procs(n, out):
+    for i in range(n):
+        out('int f%d(int a) {\n  return a + %d;\n}\n' % (i, i))
+    out('int wain(int a, int b) {\n  return f%d(a);\n}\n' % (n - 1))
+
+
+KINDS = {
+    'program': program, 'tokens': tokens, 'stmts': stmts, 'parens': parens, 'chain': chain,
+    'nest': nest, 'dcls': dcls, 'args': args, 'procs': procs,
+}
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3 or sys.argv[1] not in KINDS:
+        sys.exit('usage: wlp4programs.py {%s} N' % '|'.join(KINDS))
+    KINDS[sys.argv[1]](int(sys.argv[2]), sys.stdout.write)
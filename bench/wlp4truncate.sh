@@ -0,0 +1,129 @@
+#!/bin/sh
+# Malformed input check: builds the stages, then feeds wlp4type every
+# truncation of a generated program's parse tree and wlp4gen every
+# truncation of its typed tree, in both the text and binary formats. Text
+# trees are cut after each line, binary trees after each of STEP bytes.
+# wlp4gen is also fed the binary typed tree with the slot of one of its
+# first ID leaves replaced by one that names no variable. Each run must
+# exit normally with an "ERROR: " line. Prints the cases that crashed or
+# stayed silent and exits 1 if there were any.
+#
+# usage: bench/wlp4truncate.sh [BUILD_DIR]
+#
+# The stages are built into BUILD_DIR (a temporary directory by default)
+# with $CXX (g++) and $CXXFLAGS (-O2). PROCEDURES (10) sets the size of the
+# program and STEP (5) the stride through the binary trees.
+set -u
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BUILD=${1:-$(mktemp -d)}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--O2}
+PROCEDURES=${PROCEDURES:-10}
+STEP=${STEP:-5}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$BUILD" || exit 1
+for stage in parse/wlp4parse.cc type/wlp4type.cc codegen/wlp4gen.cc; do
+  name=$(basename "${stage%.*}")
+  $CXX -std=c++20 $CXXFLAGS -pthread -o "$BUILD/$name" "$ROOT/$stage" || exit 1
+done
+
+python3 "$ROOT/bench/wlp4programs.py" program "$PROCEDURES" > "$WORK/in.wlp4" || exit 1
+"$BUILD/wlp4parse" --scan < "$WORK/in.wlp4" > "$WORK/tree" || exit 1
+"$BUILD/wlp4type" < "$WORK/tree" > "$WORK/typed" || exit 1
+"$BUILD/wlp4parse" --scan --binary < "$WORK/in.wlp4" > "$WORK/tree.bin" || exit 1
+"$BUILD/wlp4type" --binary < "$WORK/tree.bin" > "$WORK/typed.bin" || exit 1
+
+failed=0
+# check STAGE FILE BYTES [OPTION]: runs STAGE on the first BYTES of FILE.
+check() {
+  head -c "$3" "$2" > "$WORK/cut"
+  "$BUILD/$1" ${4:-} < "$WORK/cut" > /dev/null 2> "$WORK/err"
+  rc=$?
+  if [ $rc -ge 128 ] || ! grep -q '^ERROR: ' "$WORK/err"; then
+    echo "$1 ${4:-} $(basename "$2") cut at byte $3: rc $rc $(head -n 1 "$WORK/err" | cut -c 1-60)"
+    failed=1
+  fi
+}
+for pair in wlp4type:tree wlp4gen:typed; do
+  stage=${pair%%:*}
+  file="$WORK/${pair#*:}"
+  cases=0
+  # Every line end but the last, where the tree is complete.
+  for bytes in $(awk '{ n += length($0) + 1; print n }' "$file" | sed '$d'); do
+    check "$stage" "$file" "$bytes"
+    cases=$((cases + 1))
+  done
+  size=$(wc -c < "$file.bin")
+  bytes=0
+  while [ $bytes -lt "$size" ]; do
+    check "$stage" "$file.bin" "$bytes" --binary
+    bytes=$((bytes + STEP))
+    cases=$((cases + 1))
+  done
+  echo "$stage: $cases truncated trees"
+done
+
+# corrupt LEAF VALUE: writes the binary typed tree with the slot varint of
+# its LEAF-th resolved ID leaf set to VALUE.
+corrupt() {
+  python3 - "$WORK/typed.bin" "$1" "$2" > "$WORK/corrupt" <<'PY'
+import sys
+
+def varint(data, i):
+    value = shift = 0
+    while True:
+        byte = data[i]
+        i += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, i
+
+def encode(value):
+    out = bytearray()
+    while value >= 0x80:
+        out.append(value & 0x7f | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+data = open(sys.argv[1], 'rb').read()
+leaf, value = int(sys.argv[2]), int(sys.argv[3])
+i = 8  # TREE_MAGIC
+rules, i = varint(data, i)
+for _ in range(rules):
+    length, i = varint(data, i)
+    i += length
+lexemes = found = 0
+while i < len(data):
+    code = data[i] & 0x3f
+    i += 1
+    lexeme, i = varint(data, i)
+    if code == 0x3f:  # TREE_INNER
+        continue
+    if lexeme == lexemes:
+        lexemes += 1
+        length, i = varint(data, i)
+        i += length
+    if code == 0:  # ID
+        start = i
+        slot, i = varint(data, i)
+        if slot > 0 and found == leaf:
+            sys.stdout.buffer.write(data[:start] + encode(value) + data[i:])
+            sys.exit(0)
+        found += slot > 0
+sys.exit(1)
+PY
+}
+cases=0
+for leaf in 0 1 2; do
+  for value in 200 2147483647 2147483648 4294967301; do
+    corrupt "$leaf" "$value" || exit 1
+    check wlp4gen "$WORK/corrupt" "$(wc -c < "$WORK/corrupt")" --binary
+    cases=$((cases + 1))
+  done
+done
+echo "wlp4gen: $cases corrupted slots"
+exit $failed
@@ -1,9 +1,17 @@
+#include "../common/wlp4flattree.h"
+#include "../common/wlp4intern.h"
+#include "../common/wlp4production.h"
+#include "../common/wlp4scope.h"
+#include "../common/wlp4tree.h"
+#include "../common/wlp4treetext.h"
+#include "wlp4peephole.h"
+#include <algorithm>
+#include <charconv>
+#include <functional>
 #include <iostream>
-#include <map>
-#include <memory>
-#include <set>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <unistd.h>
 #include <vector>
 
 using namespace std;
@@ -11,634 +19,1036 @@ using namespace std;
 int endNewCount = 0;
 int endDeleteCount = 0;
 
-enum class wlp4Type {
+enum class wlp4Type : uint8_t {
     INT,
     PTR,
     UNKNOWN,
 };
 
-struct symbolInfo {
-    wlp4Type type = wlp4Type::UNKNOWN;
-    int offset;
-};
-
 int IF_COUNT = 0;
 int WHILE_COUNT = 0;
 
-int MIN_OFFSET = 8;
+// Leaf lexemes are interned as the tree is read; scopes and variables are
+// keyed by symbol id.
+Interner symbols;
+const SymbolId WAIN_SCOPE = symbols.intern("wain");
+
+// Variables are found by the slot on their ID leaf: parameters, then dcls,
+// in declaration order. The parameters sit above $29 and the dcls from
+// 0($29) down, so a slot's offset only depends on the procedure's parameter
+// count.
+SymbolId SCOPE = WAIN_SCOPE;
+int PARAM_COUNT = 2;
+
+int SLOT_OFFSET(int slot) {
+    return 4 * (PARAM_COUNT - slot);
+}
+
+// The generated assembly, appended in output order. Text is gathered in a
+// buffer that goes out in large write calls to a file descriptor, or, with
+// no descriptor, all stays in memory for the caller.
+class Emitter {
+    static constexpr size_t FLUSH_SIZE = 1 << 16;
+    int fd;
+    string buffer;
+
+public:
+    explicit Emitter(int fd = -1) : fd(fd) {}
+    Emitter(const Emitter &) = delete;
+    Emitter &operator=(const Emitter &) = delete;
+    ~Emitter() {
+        flush();
+    }
+    Emitter &operator<<(string_view text) {
+        buffer.append(text);
+        if (fd >= 0 && buffer.size() >= FLUSH_SIZE) {
+            flush();
+        }
+        return *this;
+    }
+    Emitter &operator<<(int value) {
+        char digits[12];
+        char *end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        return *this << string_view(digits, end - digits);
+    }
+    void flush() {
+        if (fd < 0) {
+            return;
+        }
+        for (size_t done = 0; done < buffer.size();) {
+            ssize_t n = write(fd, buffer.data() + done, buffer.size() - done);
+            if (n <= 0) {
+                break;
+            }
+            done += n;
+        }
+        buffer.clear();
+    }
+    // Everything emitted so far, when there is no descriptor.
+    const string &text() const {
+        return buffer;
+    }
+};
+
+// What a procedure's code does with a value that may live in a register.
+enum class AsmOp : uint8_t {
+    TEXT,
+    SAVE_TEMP,    // keeps $3 as a new temporary
+    RESTORE_TEMP, // moves the newest live temporary into $arg, ending it
+    LOAD_LOCAL,   // slot arg into $3
+    STORE_LOCAL,  // $3 into slot arg
+    ENTER,        // once the frame is set up: saves and loads registers
+    LEAVE,        // before the frame is dropped: restores saved registers
+    CALL,         // a call to one of the program's procedures
+};
+
+// The code of one procedure, held until it is complete so that registers
+// can be allocated over all of it, then run through the peephole optimizer
+// and written to an Emitter.
+//
+// Two kinds of value get registers from $12-$28, by linear scan:
+//  - temporaries, the left operand an operator keeps while its right
+//    operand is evaluated, which the stack machine pushed and popped;
+//  - scalar locals, the parameters and dcls of a procedure that never
+//    takes an address, from ENTER to the end of the procedure.
+// A callee saves the registers in $12-$20 it uses and may clobber $21-$28,
+// so a value that lives across a call only gets one of the former. The
+// runtime's procedures are taken to leave them all alone, as the code
+// already relies on for $4, $11 and $29. A value left without a register
+// stays in memory, where the stack machine kept it.
+class ProcedureCode {
+    static constexpr int FIRST_REG = 12;
+    static constexpr int LAST_SAVED_REG = 20;
+    static constexpr int LAST_REG = 28;
+
+    struct Item {
+        AsmOp op;
+        int arg = 0;
+        int value = -1; // temporaries: index into the intervals
+        size_t textEnd = 0; // TEXT: its end in `text`, where the last one ended
+    };
+    // A value's lifetime, in items.
+    struct Interval {
+        int start;
+        int end;
+        int weight; // uses
+        bool acrossCall;
+        int slot = -1; // locals
+        int reg = -1;  // -1 while in memory
+    };
+
+    Emitter &output;
+    Peephole &peephole;
+    vector<MipsInstr> assembled; // before the peephole pass
+    vector<MipsInstr> optimized;
+    vector<Item> items;
+    string text;
+    vector<int> slotUses; // by slot; empty to keep locals in memory
+    bool savesRegisters = false;
+
+    vector<Interval> intervals();
+    static void allocate(vector<Interval> &values);
+    void assemble(const vector<Interval> &values, vector<MipsInstr> &code) const;
+
+public:
+    ProcedureCode(Emitter &output, Peephole &peephole) : output(output), peephole(peephole) {}
+
+    ProcedureCode &operator<<(string_view more) {
+        if (items.empty() || items.back().op != AsmOp::TEXT) {
+            items.push_back({AsmOp::TEXT});
+        }
+        text.append(more);
+        items.back().textEnd = text.size();
+        return *this;
+    }
+    ProcedureCode &operator<<(int value) {
+        char digits[12];
+        char *end = to_chars(digits, digits + sizeof(digits), value).ptr;
+        return *this << string_view(digits, end - digits);
+    }
+    void add(AsmOp op, int arg = 0) {
+        items.push_back({op, arg});
+    }
+
+    // `uses` counts the uses of each slot, or is empty to keep the locals in
+    // memory. A procedure that is called saves the registers it uses.
+    void begin(vector<int> uses, bool called) {
+        slotUses = move(uses);
+        savesRegisters = called;
+    }
+    // Allocates registers, then optimizes and writes the procedure out.
+    // Slot offsets are taken from the current PARAM_COUNT.
+    void end() {
+        vector<Interval> values = intervals();
+        allocate(values);
+        assemble(values, assembled);
+        peephole.optimize(assembled, optimized);
+        for (const MipsInstr &instr : optimized) {
+            writeInstr(output, instr);
+        }
+        items.clear();
+        text.clear();
+    }
+};
+
+// Temporaries nest, as the pushes and pops did.
+vector<ProcedureCode::Interval> ProcedureCode::intervals() {
+    int last = static_cast<int>(items.size());
+    int enter = 0;
+    vector<int> calls(last + 1, 0); // calls before each item
+    for (int i = 0; i < last; ++i) {
+        calls[i + 1] = calls[i] + (items[i].op == AsmOp::CALL);
+        if (items[i].op == AsmOp::ENTER) {
+            enter = i;
+        }
+    }
+    vector<Interval> values;
+    for (int slot = 0; slot < static_cast<int>(slotUses.size()); ++slot) {
+        if (slotUses[slot] > 0) {
+            values.push_back({enter, last, slotUses[slot], calls[last] > calls[enter], slot});
+        }
+    }
+    vector<int> open;
+    for (int i = 0; i < last; ++i) {
+        Item &item = items[i];
+        if (item.op == AsmOp::SAVE_TEMP) {
+            item.value = static_cast<int>(values.size());
+            open.push_back(item.value);
+            values.push_back({i, last, 1, calls[last] > calls[i]});
+        } else if (item.op == AsmOp::RESTORE_TEMP && !open.empty()) {
+            item.value = open.back();
+            open.pop_back();
+            Interval &value = values[item.value];
+            value.end = i;
+            value.acrossCall = calls[i] > calls[value.start];
+        }
+    }
+    return values;
+}
+
+// Values are taken in order of their start: the locals, which all start at
+// ENTER, the most used first, then the temporaries as intervals() found
+// them. Outside calls, $21-$28 go first, as they need no saving. When no
+// register is free, whichever of the new value and those holding a register
+// it could use ends last goes to memory.
+void ProcedureCode::allocate(vector<Interval> &values) {
+    vector<int> order(values.size());
+    size_t locals = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<int>(i);
+        locals += values[i].slot >= 0;
+    }
+    stable_sort(order.begin(), order.begin() + locals,
+                [&values](int a, int b) { return values[a].weight > values[b].weight; });
+    auto spillsBefore = [&values](int a, int b) {
+        return values[a].end > values[b].end || (values[a].end == values[b].end && values[a].weight < values[b].weight);
+    };
+    vector<int> active;
+    bool busy[LAST_REG + 1] = {};
+    for (int v : order) {
+        Interval &value = values[v];
+        erase_if(active, [&](int a) {
+            if (values[a].end >= value.start) {
+                return false;
+            }
+            busy[values[a].reg] = false;
+            return true;
+        });
+        for (int reg = LAST_SAVED_REG + 1; !value.acrossCall && value.reg < 0 && reg <= LAST_REG; ++reg) {
+            if (!busy[reg]) {
+                value.reg = reg;
+            }
+        }
+        for (int reg = FIRST_REG; value.reg < 0 && reg <= LAST_SAVED_REG; ++reg) {
+            if (!busy[reg]) {
+                value.reg = reg;
+            }
+        }
+        if (value.reg >= 0) {
+            busy[value.reg] = true;
+            active.push_back(v);
+            continue;
+        }
+        int victim = -1;
+        for (int a : active) {
+            if ((!value.acrossCall || values[a].reg <= LAST_SAVED_REG) && (victim < 0 || spillsBefore(a, victim))) {
+                victim = a;
+            }
+        }
+        if (victim >= 0 && spillsBefore(victim, v)) {
+            swap(value.reg, values[victim].reg);
+            *find(active.begin(), active.end(), victim) = v;
+        }
+    }
+}
+
+// The procedure's instructions, with the registers chosen: text is read
+// back, and the rest is built directly.
+void ProcedureCode::assemble(const vector<Interval> &values, vector<MipsInstr> &code) const {
+    vector<int> slotRegs(slotUses.size(), -1);
+    bool saved[LAST_REG + 1] = {};
+    for (const Interval &value : values) {
+        if (value.slot >= 0) {
+            slotRegs[value.slot] = value.reg;
+        }
+        if (savesRegisters && value.reg >= 0 && value.reg <= LAST_SAVED_REG) {
+            saved[value.reg] = true;
+        }
+    }
+    auto push = [&code](int reg) {
+        code.push_back(mipsMemory(MipsOp::SW, reg, -4, 30));
+        code.push_back(mipsInstr(MipsOp::SUB, 30, 30, 4));
+    };
+    auto pop = [&code](int reg) {
+        code.push_back(mipsInstr(MipsOp::ADD, 30, 30, 4));
+        code.push_back(mipsMemory(MipsOp::LW, reg, -4, 30));
+    };
+    code.clear();
+    size_t textStart = 0;
+    for (const Item &item : items) {
+        int reg = item.value >= 0 ? values[item.value].reg : -1;
+        if (item.op == AsmOp::LOAD_LOCAL || item.op == AsmOp::STORE_LOCAL) {
+            reg = item.arg < static_cast<int>(slotRegs.size()) ? slotRegs[item.arg] : -1;
+        }
+        switch (item.op) {
+        case AsmOp::TEXT:
+            parseAssembly(string_view(text).substr(textStart, item.textEnd - textStart), code);
+            textStart = item.textEnd;
+            break;
+        case AsmOp::SAVE_TEMP:
+            if (reg >= 0) {
+                code.push_back(mipsInstr(MipsOp::ADD, reg, 3, 0));
+            } else {
+                push(3);
+            }
+            break;
+        case AsmOp::RESTORE_TEMP:
+            if (reg >= 0) {
+                code.push_back(mipsInstr(MipsOp::ADD, item.arg, reg, 0));
+            } else {
+                pop(item.arg);
+            }
+            break;
+        case AsmOp::LOAD_LOCAL:
+            if (reg >= 0) {
+                code.push_back(mipsInstr(MipsOp::ADD, 3, reg, 0));
+            } else {
+                code.push_back(mipsMemory(MipsOp::LW, 3, SLOT_OFFSET(item.arg), 29));
+            }
+            break;
+        case AsmOp::STORE_LOCAL:
+            if (reg >= 0) {
+                code.push_back(mipsInstr(MipsOp::ADD, reg, 3, 0));
+            } else {
+                code.push_back(mipsMemory(MipsOp::SW, 3, SLOT_OFFSET(item.arg), 29));
+            }
+            break;
+        case AsmOp::ENTER:
+            for (int saveReg = FIRST_REG; saveReg <= LAST_SAVED_REG; ++saveReg) {
+                if (saved[saveReg]) {
+                    push(saveReg);
+                }
+            }
+            for (int slot = 0; slot < static_cast<int>(slotRegs.size()); ++slot) {
+                if (slotRegs[slot] >= 0) {
+                    code.push_back(mipsMemory(MipsOp::LW, slotRegs[slot], SLOT_OFFSET(slot), 29));
+                }
+            }
+            break;
+        case AsmOp::LEAVE:
+            for (int saveReg = LAST_SAVED_REG; saveReg >= FIRST_REG; --saveReg) {
+                if (saved[saveReg]) {
+                    pop(saveReg);
+                }
+            }
+            break;
+        case AsmOp::CALL:
+            break;
+        }
+    }
+}
+
+void PUSH(ProcedureCode &out, int reg) {
+    out << "sw $" << reg << ", -4($30)\nsub $30, $30, $4\n";
+}
 
-map<string, map<string, symbolInfo>> symbolTable = {{"wain", {}}};
-string SCOPE = "wain";
+void POP(ProcedureCode &out, int reg) {
+    out << "add $30, $30, $4\nlw $" << reg << ", -4($30)\n";
+}
 
-string GET_VARIABLE(string ID) {
-    if (symbolTable[SCOPE].contains(ID)) {
-        symbolInfo info = symbolTable[SCOPE][ID];
-        return "lw $3, " + to_string(info.offset) + "($29)\n";
+// Loads a variable into $3.
+void GET_VARIABLE(ProcedureCode &out, SymbolId ID, int slot) {
+    if (slot >= 0) {
+        out.add(AsmOp::LOAD_LOCAL, slot);
+        return;
     }
-    return "NO SUCH VARIABLE " + SCOPE + " " + ID + "\n";
+    out << "NO SUCH VARIABLE " << symbols.name(SCOPE) << " " << symbols.name(ID) << "\n";
+}
+
+void SAVE_TEMP(ProcedureCode &out, int) {
+    out.add(AsmOp::SAVE_TEMP);
+}
+
+void RESTORE_TEMP(ProcedureCode &out, int reg) {
+    out.add(AsmOp::RESTORE_TEMP, reg);
+}
+
+void STORE_LOCAL(ProcedureCode &out, int slot) {
+    out.add(AsmOp::STORE_LOCAL, slot);
 }
 
-string RETURN(int offset) {
-    return "lw $3, " + to_string(offset) + "($29)\n";
+void ENTER(ProcedureCode &out, int) {
+    out.add(AsmOp::ENTER);
 }
 
-string PUSH(int reg) {
-    MIN_OFFSET -= 4;
-    return "sw $" + to_string(reg) + ", -4($30)\nsub $30, $30, $4\n";
+void LEAVE(ProcedureCode &out, int) {
+    out.add(AsmOp::LEAVE);
 }
 
-string POP(int reg) {
-    MIN_OFFSET += 4;
-    return "add $30, $30, $4\nlw $" + to_string(reg) + ", -4($30)\n";
+void CALL(ProcedureCode &out, int) {
+    out.add(AsmOp::CALL);
 }
 
-string EPILOGUE(int varCount) {
-    string result = "";
+void EPILOGUE(ProcedureCode &out, int varCount) {
     for (int i = 0; i < varCount; i++) {
-        result += "add $30, $30, $4\n";
-    }
-    result += "jr $31\n";
-    return result;
-}
-
-string P_LABEL(string label) {
-    return "P" + label + ":\n";
-}
-
-string PROLOGUE = ".import init\n.import new\n.import delete\n.import print\nlis $4\n.word 4\nlis $11\n.word 1\n";
-// string PROLOGUE = "lis $4\n.word 4\nlis $11\n.word 1\n";
-string SET_FRAME_PTR = "sub $29, $30, $4\n";
-
-string concatCode(const vector<string> &codelines) {
-    string result = "";
-    for (auto &codeline : codelines) {
-        result += codeline;
-    }
-    return result;
-}
-
-const std::set<std::string> terminalSymbol = {
-    "ID",
-    "NUM",
-    "LPAREN",
-    "RPAREN",
-    "LBRACE",
-    "RBRACE",
-    "RETURN",
-    "IF",
-    "ELSE",
-    "WHILE",
-    "PRINTLN",
-    "PUTCHAR",
-    "GETCHAR",
-    "WAIN",
-    "BECOMES",
-    "INT",
-    "EQ",
-    "NE",
-    "LT",
-    "GT",
-    "LE",
-    "GE",
-    "PLUS",
-    "MINUS",
-    "STAR",
-    "SLASH",
-    "PCT",
-    "COMMA",
-    "SEMI",
-    "NEW",
-    "DELETE",
-    "LBRACK",
-    "RBRACK",
-    "AMP",
-    "NULL",
-    "BOF",
-    "EOF",
-};
+        out << "add $30, $30, $4\n";
+    }
+    out << "jr $31\n";
+}
 
-bool isTerminal(const std::string &token) {
-    return terminalSymbol.contains(token);
+void P_LABEL(ProcedureCode &out, string_view label) {
+    out << "P" << label << ":\n";
 }
 
+// A numbered label, such as ELSE3, followed by `suffix`.
+void LABEL(ProcedureCode &out, string_view name, int number, string_view suffix = ":\n") {
+    out << name << number << suffix;
+}
+
+const char *PROLOGUE = ".import init\n.import new\n.import delete\n.import print\nlis $4\n.word 4\nlis $11\n.word 1\n";
+const char *SET_FRAME_PTR = "sub $29, $30, $4\n";
+const char *CALL_INIT = "lis $10\n.word init\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n";
+
 void outputError(std::string msg = "") {
     std::cerr << "ERROR: " << msg << std::endl;
 }
 
-struct Node {
-    string lhs = "";
-    string rhs = "";
-    wlp4Type type = wlp4Type::UNKNOWN;
-    vector<unique_ptr<Node>> children = {};
-    explicit Node(std::string lhs) : lhs(lhs) {}
-    void populate(std::istream &in) {
-        std::string read;
-        getline(in, read);
-        std::istringstream iss{read};
-        iss >> read;
-        if (isTerminal(read)) {
-            // leaf node
-            iss >> rhs;
-            if (iss >> read && read == ":") {
-                iss >> read;
-                if (read == "int") {
-                    type = wlp4Type::INT;
-                } else if (read == "int*") {
-                    type = wlp4Type::PTR;
-                }
-            }
-            return;
+// The tree, in pre-order; see common/wlp4flattree.h.
+FlatTree<wlp4Type> nodes;
+
+// One step of a node's code: a child whose code goes here, fixed text, or
+// an emitter run once the steps before it have run. Emitters that need more
+// than one int are deferred functions.
+struct CodeStep {
+    NodeId node = NO_NODE;
+    int arg = 3; // a child's pushReg, or the emitter's argument
+    string_view text;
+    void (*emit)(ProcedureCode &, int) = nullptr;
+    function<void(ProcedureCode &)> deferred;
+
+    CodeStep(NodeId node, int pushReg = 3) : node(node), arg(pushReg) {}
+    // `text` must outlive the step: a literal or an interned name.
+    CodeStep(string_view text) : text(text) {}
+    CodeStep(const char *text) : text(text) {}
+    CodeStep(void (*emit)(ProcedureCode &, int), int arg) : arg(arg), emit(emit) {}
+    static CodeStep later(function<void(ProcedureCode &)> deferred) {
+        CodeStep step("");
+        step.deferred = move(deferred);
+        return step;
+    }
+};
+
+// Reads the tree in pre-order, one node per line, each optionally followed
+// by " : " and its type. false if a line is neither a leaf nor a WLP4 rule,
+// is not the symbol its parent's rule has there, or the input ends first.
+bool populate(TextTreeReader &in) {
+    nodes.reserve(in.linesLeft());
+    TextTreeLine line;
+    while (!nodes.complete()) {
+        if (!in.next(line) || !nodes.fits(line.production, line.code)) {
+            return false;
         }
-        while (iss >> read) {
-            if (read == ".EMPTY") {
-                rhs = ".EMPTY";
-                return;
-            }
-            if (read == ":") {
-                iss >> read;
-                if (read == "int") {
-                    type = wlp4Type::INT;
-                } else if (read == "int*") {
-                    type = wlp4Type::PTR;
-                }
-                break;
-            }
-            if (rhs.length() > 0) {
-                rhs += " ";
-            }
-            rhs += read;
-            children.emplace_back(std::make_unique<Node>(read));
+        wlp4Type type = wlp4Type::UNKNOWN;
+        if (line.type == TreeType::INT) {
+            type = wlp4Type::INT;
+        } else if (line.type == TreeType::PTR) {
+            type = wlp4Type::PTR;
         }
-        for (auto &child : children) {
-            child->populate(in);
+        if (line.production == Production::NONE) {
+            nodes.appendLeaf(line.code, symbols.intern(line.lexeme), type);
+        } else {
+            nodes.appendInner(line.production, type);
         }
     }
-    void print() {
-        std::cout << lhs << " " << rhs;
-        if (type != wlp4Type::UNKNOWN) {
-            std::cout << " : " << (type == wlp4Type::INT ? "int" : "int*");
+    return true;
+}
+
+// The binary format carries the slots the type checker resolved. A slot
+// must name one of its procedure's parameters or dcls, all of which come
+// before any use in pre-order.
+bool populate(TreeReader &in) {
+    vector<Production> productions = treeProductions(in.rules());
+    TreeRecord record;
+    int variables = 0; // parameters and dcls of the procedure so far
+    while (!nodes.complete()) {
+        if (!in.next(record)) {
+            return false;
         }
-        std::cout << std::endl;
-        for (auto &child : children) {
-            child->print();
+        wlp4Type type = wlp4Type::UNKNOWN;
+        if (record.type == TreeType::INT) {
+            type = wlp4Type::INT;
+        } else if (record.type == TreeType::PTR) {
+            type = wlp4Type::PTR;
         }
-    }
-
-    int getLvalueOffset() {
-        if (lhs != "lvalue") {
-            return -1;
+        if (record.leaf) {
+            if (!nodes.fits(Production::NONE, record.code) || record.slot >= variables) {
+                return false;
+            }
+            nodes.appendLeaf(record.code, record.lexeme, type, record.slot);
+            continue;
         }
-        if (rhs == "ID") {
-            Node *ID = children[0].get();
-            return symbolTable[SCOPE][ID->rhs].offset;
+        Production rule = productions[record.ruleId];
+        if (rule == Production::NONE || !nodes.fits(rule, TREE_INNER)) {
+            return false;
         }
-        if (rhs == "LPAREN lvalue RPAREN") {
-            return children[1]->getLvalueOffset();
+        if (rule == Production::PROCEDURE || rule == Production::MAIN) {
+            variables = 0;
+        } else if (rule == Production::DCL) {
+            ++variables;
         }
-        return -1;
+        nodes.appendInner(rule, type);
     }
+    return true;
+}
 
-    int countArgs() {
-        if (lhs == "arglist") {
-            if (rhs == "expr") {
-                return 1;
-            }
-            if (rhs == "expr COMMA arglist") {
-                return 1 + children[2]->countArgs();
+// The text format has no slots, so they are resolved here as the type
+// checker does: each procedure's parameters and dcls come before any use
+// in pre-order.
+void resolveSlots() {
+    ScopeTable variables;
+    for (NodeId node = 0; node < nodes.size();) {
+        switch (nodes.rules[node]) {
+        case Production::PROCEDURE:
+        case Production::MAIN:
+            variables = ScopeTable();
+            break;
+        case Production::DCL: {
+            NodeId ID = nodes.child(node, 1);
+            nodes.slots[ID] = variables.declare(nodes.lexemes[ID]);
+            node = nodes.ends[node];
+            continue;
+        }
+        case Production::NONE:
+            if (nodes.is(node, TokenKind::ID)) {
+                nodes.slots[node] = variables.find(nodes.lexemes[node]);
             }
+            break;
+        default:
+            break;
         }
-        return 0;
+        ++node;
     }
+}
 
-    int processParamlist() {
-        if (lhs != "paramlist") {
-            return 0;
+void print() {
+    for (NodeId node = 0; node < nodes.size(); ++node) {
+        if (nodes.rules[node] != Production::NONE) {
+            std::cout << productionRule(nodes.rules[node]).text;
+        } else {
+            std::cout << WLP4_CFG.names[nodes.leafCodes[node]] << " " << symbols.name(nodes.lexemes[node]);
         }
-        if (rhs == "dcl" || rhs == "dcl COMMA paramlist") {
-            Node *dcl = children[0].get();
-            Node *ID = dcl->children[1].get();
-            string IDStr = ID->rhs;
-            wlp4Type idType = ID->type;
-            symbolTable[SCOPE][IDStr] = {idType, MIN_OFFSET};
-            MIN_OFFSET -= 4;
-            if (rhs == "dcl") {
-                return 1;
-            }
-            if (rhs == "dcl COMMA paramlist") {
-                return 1 + children[2]->processParamlist();
-            }
+        if (nodes.types[node] != wlp4Type::UNKNOWN) {
+            std::cout << " : " << (nodes.types[node] == wlp4Type::INT ? "int" : "int*");
         }
-        return 0;
+        std::cout << "\n";
     }
+}
 
-    void processParams() {
-        if (lhs == "params") {
-            if (rhs == "paramlist") {
-                children[0]->processParamlist();
-            }
-        }
+// Looks through any LPAREN lvalue RPAREN wrapping.
+NodeId unwrapLvalue(NodeId lvalue) {
+    while (nodes.rules[lvalue] == Production::LVALUE_PARENS) {
+        lvalue = nodes.child(lvalue, 1);
     }
+    return lvalue;
+}
 
-    int countParams() {
-        if (lhs == "params") {
-            if (rhs == "paramlist") {
-                return children[0]->count_Paramlist();
-            }
-        }
-        return 0;
+int getLvalueOffset(NodeId node) {
+    NodeId lvalue = unwrapLvalue(node);
+    if (nodes.rules[lvalue] == Production::LVALUE_ID) {
+        return SLOT_OFFSET(nodes.slots[nodes.child(lvalue, 0)]);
     }
+    return -1;
+}
 
-    string getLvalueTerminal() {
-        if (lhs == "lvalue") {
-            if (rhs == "LPAREN lvalue RPAREN") {
-                return children[1]->getLvalueTerminal();
-            } else {
-                return rhs;
-            }
-        }
-        return "";
+// arglist and paramlist are right-recursive; they are walked as lists.
+int countArgs(NodeId list) {
+    int count = 0;
+    for (; nodes.rules[list] == Production::ARGLIST_MORE; list = nodes.child(list, 2)) {
+        ++count;
     }
+    return nodes.rules[list] == Production::ARGLIST_EXPR ? count + 1 : count;
+}
 
-    int count_Paramlist() {
-        if (lhs == "paramlist") {
-            if (rhs == "dcl") {
-                return 1;
-            }
-            if (rhs == "dcl COMMA paramlist") {
-                return 1 + children[2]->count_Paramlist();
-            }
+int count_Paramlist(NodeId list) {
+    int count = 0;
+    for (; nodes.rules[list] == Production::PARAMLIST_MORE; list = nodes.child(list, 2)) {
+        ++count;
+    }
+    return nodes.rules[list] == Production::PARAMLIST_DCL ? count + 1 : count;
+}
+
+int countParams(NodeId params) {
+    if (nodes.rules[params] == Production::PARAMS_LIST) {
+        return count_Paramlist(nodes.child(params, 0));
+    }
+    return 0;
+}
+
+// How often each of the procedure's variables is named, by slot, or
+// nothing if it takes an address anywhere, which keeps them all in memory.
+vector<int> localUses(NodeId procedure) {
+    vector<int> uses;
+    for (NodeId node = procedure; node < nodes.ends[procedure]; ++node) {
+        if (nodes.rules[node] == Production::FACTOR_AMP) {
+            return {};
         }
-        return 0;
+        int slot = nodes.slots[node];
+        if (slot >= static_cast<int>(uses.size())) {
+            uses.resize(slot + 1);
+        }
+        if (slot >= 0) {
+            ++uses[slot];
+        }
+    }
+    return uses;
+}
+
+// The production of the lvalue inside any parentheses.
+Production getLvalueTerminal(NodeId lvalue) {
+    return nodes.rules[unwrapLvalue(lvalue)];
+}
+
+// The code of a test: both exprs, then the comparison, leaving 0 or 1 in $3.
+vector<CodeStep> compareCode(NodeId node) {
+    NodeId expr1 = nodes.child(node, 0);
+    NodeId expr2 = nodes.child(node, 2);
+    const char *sltFunction = "slt";
+    wlp4Type expr1Type = nodes.types[expr1];
+    wlp4Type expr2Type = nodes.types[expr2];
+    if (expr1Type == wlp4Type::PTR && expr2Type == wlp4Type::PTR) {
+        sltFunction = "sltu";
+    }
+    switch (nodes.rules[node]) {
+    case Production::TEST_EQ:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction,
+                           " $6, $3, $5\n",
+                           sltFunction,
+                           " $7, $5, $3\n",
+                           "add $3, $6, $7\n",
+                           "sub $3, $11, $3\n"};
+    case Production::TEST_NE:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction, " $6, $3, $5\n",
+                           sltFunction, " $7, $5, $3\n",
+                           "add $3, $6, $7\n"};
+    case Production::TEST_LT:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction, " $3, $5, $3\n"};
+    case Production::TEST_LE:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction, " $3, $3, $5\nsub $3, $11, $3\n"};
+    case Production::TEST_GE:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction, " $3, $5, $3\nsub $3, $11, $3\n"};
+    case Production::TEST_GT:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5},
+                           sltFunction, " $3, $3, $5\n"};
+    default:
+        return {};
     }
+}
+
+// The steps that make up this node's code, in output order.
+vector<CodeStep> code(NodeId node, int pushReg = 3) {
+    switch (nodes.rules[node]) {
+    case Production::START:
+        return {nodes.child(node, 1)};
+    case Production::PROCEDURES_MAIN:
+        return {nodes.child(node, 0)};
+    case Production::PROCEDURES_MORE:
+        return {nodes.child(node, 1), nodes.child(node, 0)};
+    case Production::PROCEDURE: {
+        NodeId ID = nodes.child(node, 1);
+        NodeId dcls = nodes.child(node, 6);
+        NodeId statements = nodes.child(node, 7);
+        NodeId params = nodes.child(node, 3);
+        NodeId expr = nodes.child(node, 9);
+        int saveParams = PARAM_COUNT;
+        SymbolId saveScope = SCOPE;
+        SCOPE = nodes.lexemes[ID];
+        PARAM_COUNT = countParams(params);
+        string_view name = symbols.name(nodes.lexemes[ID]);
 
-    string code(int pushReg = 3) {
-        if (lhs == "start" && rhs == "BOF procedures EOF") {
-            return children[1]->code();
+        vector<int> uses = localUses(node);
+
+        // The caller's scope is restored once the body is done.
+        return {
+            CodeStep::later([name, uses](ProcedureCode &out) {
+                out.begin(uses, true);
+                P_LABEL(out, name);
+            }),
+            "sub $29, $30, $4\n",
+            dcls,
+            {ENTER, 0},
+            statements,
+            expr,
+            CodeStep::later([saveParams, saveScope](ProcedureCode &out) {
+                LEAVE(out, 0);
+                out << "add $30, $29, $4\n"
+                    << "jr $31\n";
+                out.end();
+                PARAM_COUNT = saveParams;
+                SCOPE = saveScope;
+            }),
+        };
+    }
+    case Production::MAIN: {
+        SCOPE = WAIN_SCOPE;
+        PARAM_COUNT = 2;
+        NodeId dcl1 = nodes.child(node, 3);
+        NodeId dcl2 = nodes.child(node, 5);
+        NodeId dcls = nodes.child(node, 8);
+        NodeId statements = nodes.child(node, 9);
+        NodeId returnExp = nodes.child(node, 11);
+        vector<int> uses = localUses(node);
+        CodeStep begin = CodeStep::later([uses](ProcedureCode &out) { out.begin(uses, false); });
+        CodeStep end = CodeStep::later([](ProcedureCode &out) {
+            EPILOGUE(out, 2);
+            out.end();
+        });
+        // init gets $2 = 0 unless the first parameter is an array.
+        wlp4Type dcl1Type = nodes.types[nodes.child(dcl1, 1)];
+        if (dcl1Type == wlp4Type::PTR) {
+            return {begin, PROLOGUE, CALL_INIT, CodeStep(dcl1, 1), CodeStep(dcl2, 2), SET_FRAME_PTR, dcls,
+                    {ENTER, 0}, statements, returnExp, end};
         }
-        if (lhs == "procedures") {
-            if (rhs == "main") {
-                return children[0]->code();
-            }
-            if (rhs == "procedure procedures") {
-                return concatCode({children[1]->code(), children[0]->code()});
-            }
+        return {begin, PROLOGUE, {PUSH, 2}, "add $2, $0, $0\n", CALL_INIT, {POP, 2}, CodeStep(dcl1, 1),
+                CodeStep(dcl2, 2), SET_FRAME_PTR, dcls, {ENTER, 0}, statements, returnExp, end};
+    }
+    case Production::DCLS_NUM: {
+        NodeId dcl = nodes.child(node, 1);
+        NodeId Num = nodes.child(node, 3);
+        return {nodes.child(node, 0), Num, dcl};
+    }
+    case Production::DCLS_NULL: {
+        NodeId dcl = nodes.child(node, 1);
+        return {nodes.child(node, 0), "add $3, $11, $0\n", dcl};
+    }
+    case Production::STATEMENTS_MORE:
+        return {nodes.child(node, 0), nodes.child(node, 1)};
+    case Production::DCL:
+        return {{PUSH, pushReg}};
+    case Production::EXPR_TERM:
+        return {nodes.child(node, 0)};
+    case Production::EXPR_PLUS: {
+        NodeId expr = nodes.child(node, 0);
+        NodeId term = nodes.child(node, 2);
+        wlp4Type termType = nodes.types[term];
+        wlp4Type exprType = nodes.types[expr];
+        if (termType == wlp4Type::INT && exprType == wlp4Type::INT) {
+            return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2),
+                               {RESTORE_TEMP, 5}, "add $3, $5, $3\n"};
         }
-        if (lhs == "procedure" && rhs == "INT ID LPAREN params RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE") {
-            Node *ID = children[1].get();
-            Node *dcls = children[6].get();
-            Node *statements = children[7].get();
-            Node *params = children[3].get();
-            Node *expr = children[9].get();
-            int saveMin = MIN_OFFSET;
-            string saveScope = SCOPE;
-            SCOPE = ID->rhs;
-            MIN_OFFSET = params->countParams() * 4;
-            params->processParams();
-
-            string pushReg = "";
-            string popReg = "";
-            string dclsCode = dcls->code();
-            for (int i = 0; i < 21; ++i) {
-                if (i == 3)
-                    continue;
-                pushReg += PUSH(i);
-            }
-            string code = concatCode({
-                P_LABEL(ID->rhs),
-                "sub $29, $30, $4\n",
-                dclsCode,
-                pushReg,
-                statements->code(),
-                expr->code(),
-
-            });
-            for (int i = 20; i >= 0; --i) {
-                if (i == 3)
-                    continue;
-                popReg += POP(i);
-            }
-            code += concatCode({
-                popReg,
-                "add $30, $29, $4\n",
-                "jr $31\n",
-            });
-
-            MIN_OFFSET = saveMin;
-            SCOPE = saveScope;
-            return code;
-        }
-        if (lhs == "main" && rhs == "INT WAIN LPAREN dcl COMMA dcl RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE") {
-            Node *dcl1 = children[3].get();
-            Node *dcl2 = children[5].get();
-            Node *dcls = children[8].get();
-            Node *statements = children[9].get();
-            Node *returnExp = children[11].get();
-            string initCode = concatCode({
-                PUSH(2),
-                "add $2, $0, $0\n",
-                "lis $10\n.word init\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n",
-                POP(2),
-            });
-            wlp4Type dcl1Type = dcl1->children[1]->type;
-            if (dcl1Type == wlp4Type::PTR) {
-                initCode = "lis $10\n.word init\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n";
-            }
-            return concatCode({PROLOGUE, initCode, dcl1->code(1), dcl2->code(2), SET_FRAME_PTR, dcls->code(),
-                               statements->code(), returnExp->code(), EPILOGUE(2)});
-        }
-        if (lhs == "dcls") {
-            if (rhs == "dcls dcl BECOMES NUM SEMI") {
-                Node *dcl = children[1].get();
-                Node *Num = children[3].get();
-                return concatCode({children[0]->code(), Num->code(), dcl->code()});
-            }
-            if (rhs == "dcls dcl BECOMES NULL SEMI") {
-                Node *dcl = children[1].get();
-                return concatCode({children[0]->code(), "add $3, $11, $0\n", dcl->code()});
-            }
+        if (exprType == wlp4Type::PTR && termType == wlp4Type::INT) {
+            return {
+                expr,
+                {SAVE_TEMP, 3},
+                term,
+                "mult $3, $4\nmflo $3\n",
+                {RESTORE_TEMP, 5},
+                "add $3, $5, $3\n",
+            };
         }
-        if (lhs == "statements" && rhs == "statements statement") {
-            return concatCode({children[0]->code(), children[1]->code()});
+        if (exprType == wlp4Type::INT && termType == wlp4Type::PTR) {
+            return {
+                term,
+                {SAVE_TEMP, 3},
+                expr,
+                "mult $3, $4\nmflo $3\n",
+                {RESTORE_TEMP, 5},
+                "add $3, $5, $3\n",
+            };
         }
-
-        if (lhs == "dcl" && rhs == "type ID") {
-            Node *ID = children[1].get();
-            string IDStr = ID->rhs;
-            wlp4Type idType = ID->type;
-            symbolTable[SCOPE][IDStr] = {idType, MIN_OFFSET};
-            return PUSH(pushReg);
+        break;
+    }
+    case Production::EXPR_MINUS: {
+        NodeId expr = nodes.child(node, 0);
+        NodeId term = nodes.child(node, 2);
+        wlp4Type termType = nodes.types[term];
+        wlp4Type exprType = nodes.types[expr];
+        if (exprType == wlp4Type::INT && termType == wlp4Type::INT) {
+            return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2),
+                               {RESTORE_TEMP, 5}, "sub $3, $5, $3\n"};
         }
-        if (lhs == "expr") {
-            if (rhs == "term") {
-                return children[0]->code();
-            }
-            if (rhs == "expr PLUS term") {
-                Node *expr = children[0].get();
-                Node *term = children[2].get();
-                wlp4Type termType = term->type;
-                wlp4Type exprType = expr->type;
-                if (termType == wlp4Type::INT && exprType == wlp4Type::INT) {
-                    return concatCode({children[0]->code(), PUSH(3), children[2]->code(),
-                                       POP(5), "add $3, $5, $3\n"});
-                }
-                if (exprType == wlp4Type::PTR && termType == wlp4Type::INT) {
-                    return concatCode({
-                        expr->code(),
-                        PUSH(3),
-                        term->code(),
-                        "mult $3, $4\nmflo $3\n",
-                        POP(5),
-                        "add $3, $5, $3\n",
-                    });
-                }
-                if (exprType == wlp4Type::INT && termType == wlp4Type::PTR) {
-                    return concatCode({
-                        term->code(),
-                        PUSH(3),
-                        expr->code(),
-                        "mult $3, $4\nmflo $3\n",
-                        POP(5),
-                        "add $3, $5, $3\n",
-                    });
-                }
-            }
-            if (rhs == "expr MINUS term") {
-                Node *expr = children[0].get();
-                Node *term = children[2].get();
-                wlp4Type termType = term->type;
-                wlp4Type exprType = expr->type;
-                if (exprType == wlp4Type::INT && termType == wlp4Type::INT) {
-                    return concatCode({children[0]->code(), PUSH(3), children[2]->code(),
-                                       POP(5), "sub $3, $5, $3\n"});
-                }
-                if (exprType == wlp4Type::PTR && termType == wlp4Type::INT) {
-                    return concatCode({
-                        expr->code(),
-                        PUSH(3),
-                        term->code(),
-                        "mult $3, $4\nmflo $3\n",
-                        POP(5),
-                        "sub $3, $5, $3\n",
-                    });
-                }
-                if (exprType == wlp4Type::PTR && termType == wlp4Type::PTR) {
-                    return concatCode({
-                        expr->code(),
-                        PUSH(3),
-                        term->code(),
-                        POP(5),
-                        "sub $3, $5, $3\n",
-                        "div $3, $4\nmflo $3\n",
-                    });
-                }
-            }
+        if (exprType == wlp4Type::PTR && termType == wlp4Type::INT) {
+            return {
+                expr,
+                {SAVE_TEMP, 3},
+                term,
+                "mult $3, $4\nmflo $3\n",
+                {RESTORE_TEMP, 5},
+                "sub $3, $5, $3\n",
+            };
         }
-        if (lhs == "statement") {
-            if (rhs == "lvalue BECOMES expr SEMI") {
-                Node *lvalue = children[0].get();
-                Node *expr = children[2].get();
-                if (lvalue->getLvalueTerminal() == "ID") {
-                    int offset = lvalue->getLvalueOffset();
-                    return concatCode({expr->code(), "sw $3, " + to_string(offset) + "($29)\n"});
-                }
-                if (lvalue->getLvalueTerminal() == "STAR factor") {
-                    Node *factor = lvalue->children[1].get();
-                    return concatCode({
-                        expr->code(),
-                        PUSH(3),
-                        factor->code(),
-                        POP(5),
-                        "sw $5, 0($3)\n",
-                    });
-                }
-            }
-            if (rhs == "IF LPAREN test RPAREN LBRACE statements RBRACE ELSE LBRACE statements RBRACE") {
-                Node *test = children[2].get();
-                Node *statements1 = children[5].get();
-                Node *statements2 = children[9].get();
-                int ifCount = IF_COUNT++;
-                return concatCode({test->code(), "beq $3, $0, ELSE" + to_string(ifCount) + "\n",
-                                   statements1->code(), "beq $0, $0, ENDIF" + to_string(ifCount) + "\n",
-                                   "ELSE" + to_string(ifCount) + ":\n", statements2->code(),
-                                   "ENDIF" + to_string(ifCount) + ":\n"});
-            }
-            if (rhs == "WHILE LPAREN test RPAREN LBRACE statements RBRACE") {
-                Node *test = children[2].get();
-                Node *statements = children[5].get();
-                int whileCount = WHILE_COUNT++;
-                return concatCode({"WHILE" + to_string(whileCount) + ":\n", test->code(),
-                                   "beq $3, $0, ENDWHILE" + to_string(whileCount) + "\n",
-                                   statements->code(), "beq $0, $0, WHILE" + to_string(whileCount) + "\n",
-                                   "ENDWHILE" + to_string(whileCount) + ":\n"});
-            }
-            if (rhs == "PUTCHAR LPAREN expr RPAREN SEMI") {
-                return concatCode({children[2]->code(),
-                                   "lis $5\n.word 0xffff000c\nsw $3, 0($5)\n"});
-            }
-
-            if (rhs == "PRINTLN LPAREN expr RPAREN SEMI") {
-                return concatCode({children[2]->code(),
-                                   "add $1, $3, $0\n",
-                                   "lis $10\n.word print\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n"});
-            }
-            if (rhs == "DELETE LBRACK RBRACK expr SEMI") {
-                Node *expr = children[3].get();
-                endDeleteCount++;
-                return concatCode({expr->code(),
-                                   "beq $3, $11, ENDDELETE" + to_string(endDeleteCount) + "\n",
-                                   "add $1, $3, $0\n",
-                                   "lis $10\n.word delete\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n",
-                                   "ENDDELETE" + to_string(endDeleteCount) + ":\n"});
-            }
+        if (exprType == wlp4Type::PTR && termType == wlp4Type::PTR) {
+            return {
+                expr,
+                {SAVE_TEMP, 3},
+                term,
+                {RESTORE_TEMP, 5},
+                "sub $3, $5, $3\n",
+                "div $3, $4\nmflo $3\n",
+            };
         }
-        if (lhs == "test") {
-            Node *expr1 = children[0].get();
-            Node *expr2 = children[2].get();
-            string sltFunction = "slt";
-            wlp4Type expr1Type = expr1->type;
-            wlp4Type expr2Type = expr2->type;
-            if (expr1Type == wlp4Type::PTR && expr2Type == wlp4Type::PTR) {
-                sltFunction = "sltu";
-            }
-            if (rhs == "expr EQ expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction,
-                                   " $6, $3, $5\n",
-                                   sltFunction,
-                                   " $7, $5, $3\n",
-                                   "add $3, $6, $7\n",
-                                   "sub $3, $11, $3\n"});
-            }
-            if (rhs == "expr NE expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction, " $6, $3, $5\n",
-                                   sltFunction, " $7, $5, $3\n",
-                                   "add $3, $6, $7\n"});
-            }
-            if (rhs == "expr LT expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction, " $3, $5, $3\n"});
-            }
-            if (rhs == "expr LE expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction, " $3, $3, $5\nsub $3, $11, $3\n"});
-            }
-            if (rhs == "expr GE expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction, " $3, $5, $3\nsub $3, $11, $3\n"});
-            }
-            if (rhs == "expr GT expr") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5),
-                                   sltFunction, " $3, $3, $5\n"});
+        break;
+    }
+    case Production::STATEMENT_ASSIGN: {
+        NodeId lvalue = nodes.child(node, 0);
+        NodeId expr = nodes.child(node, 2);
+        if (getLvalueTerminal(lvalue) == Production::LVALUE_ID) {
+            int offset = getLvalueOffset(lvalue);
+            int slot = nodes.slots[nodes.child(unwrapLvalue(lvalue), 0)];
+            if (slot >= 0) {
+                return {expr, {STORE_LOCAL, slot}};
             }
+            return {expr, CodeStep::later([offset](ProcedureCode &out) { out << "sw $3, " << offset << "($29)\n"; })};
         }
-        if (lhs == "term") {
-            if (rhs == "factor") {
-                return children[0]->code();
-            }
-            if (rhs == "term STAR factor") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5), "mult $3, $5\nmflo $3\n"});
-            }
-            if (rhs == "term SLASH factor") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5), "div $5, $3\nmflo $3\n"});
-            }
-            if (rhs == "term PCT factor") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code(), POP(5), "div $5, $3\nmfhi $3\n"});
-            }
+        if (getLvalueTerminal(lvalue) == Production::LVALUE_STAR) {
+            NodeId factor = nodes.child(lvalue, 1);
+            return {
+                expr,
+                {SAVE_TEMP, 3},
+                factor,
+                {RESTORE_TEMP, 5},
+                "sw $5, 0($3)\n",
+            };
         }
-        if (lhs == "NUM") {
-            return "lis $3\n.word " + rhs + "\n";
+        break;
+    }
+    case Production::STATEMENT_IF: {
+        NodeId test = nodes.child(node, 2);
+        NodeId statements1 = nodes.child(node, 5);
+        NodeId statements2 = nodes.child(node, 9);
+        int ifCount = IF_COUNT++;
+        return {test,
+                CodeStep::later([ifCount](ProcedureCode &out) { LABEL(out, "beq $3, $0, ELSE", ifCount, "\n"); }),
+                statements1,
+                CodeStep::later([ifCount](ProcedureCode &out) {
+                    LABEL(out, "beq $0, $0, ENDIF", ifCount, "\n");
+                    LABEL(out, "ELSE", ifCount);
+                }),
+                statements2,
+                CodeStep::later([ifCount](ProcedureCode &out) { LABEL(out, "ENDIF", ifCount); })};
+    }
+    case Production::STATEMENT_WHILE: {
+        NodeId test = nodes.child(node, 2);
+        NodeId statements = nodes.child(node, 5);
+        int whileCount = WHILE_COUNT++;
+        return {CodeStep::later([whileCount](ProcedureCode &out) { LABEL(out, "WHILE", whileCount); }),
+                test,
+                CodeStep::later([whileCount](ProcedureCode &out) { LABEL(out, "beq $3, $0, ENDWHILE", whileCount, "\n"); }),
+                statements,
+                CodeStep::later([whileCount](ProcedureCode &out) {
+                    LABEL(out, "beq $0, $0, WHILE", whileCount, "\n");
+                    LABEL(out, "ENDWHILE", whileCount);
+                })};
+    }
+    case Production::STATEMENT_PUTCHAR:
+        return {nodes.child(node, 2),
+                           "lis $5\n.word 0xffff000c\nsw $3, 0($5)\n"};
+    case Production::STATEMENT_PRINTLN:
+        return {nodes.child(node, 2),
+                           "add $1, $3, $0\n",
+                           "lis $10\n.word print\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n"};
+    case Production::STATEMENT_DELETE: {
+        NodeId expr = nodes.child(node, 3);
+        int deleteCount = ++endDeleteCount;
+        return {expr,
+                CodeStep::later([deleteCount](ProcedureCode &out) { LABEL(out, "beq $3, $11, ENDDELETE", deleteCount, "\n"); }),
+                "add $1, $3, $0\n",
+                "lis $10\n.word delete\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n",
+                CodeStep::later([deleteCount](ProcedureCode &out) { LABEL(out, "ENDDELETE", deleteCount); })};
+    }
+    case Production::TEST_EQ:
+    case Production::TEST_NE:
+    case Production::TEST_LT:
+    case Production::TEST_LE:
+    case Production::TEST_GE:
+    case Production::TEST_GT:
+        return compareCode(node);
+    case Production::TERM_FACTOR:
+        return {nodes.child(node, 0)};
+    case Production::TERM_STAR:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5}, "mult $3, $5\nmflo $3\n"};
+    case Production::TERM_SLASH:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5}, "div $5, $3\nmflo $3\n"};
+    case Production::TERM_PCT:
+        return {nodes.child(node, 0), {SAVE_TEMP, 3}, nodes.child(node, 2), {RESTORE_TEMP, 5}, "div $5, $3\nmfhi $3\n"};
+    case Production::NONE:
+        if (nodes.is(node, TokenKind::NUM)) {
+            return {"lis $3\n.word ", symbols.name(nodes.lexemes[node]), "\n"};
         }
-        if (lhs == "arglist") {
-            if (rhs == "expr") {
-                return concatCode({children[0]->code(), PUSH(3)});
-            }
-            if (rhs == "expr COMMA arglist") {
-                return concatCode({children[0]->code(), PUSH(3), children[2]->code()});
-            }
+        break;
+    case Production::ARGLIST_EXPR:
+        return {nodes.child(node, 0), {PUSH, 3}};
+    case Production::ARGLIST_MORE:
+        return {nodes.child(node, 0), {PUSH, 3}, nodes.child(node, 2)};
+    case Production::FACTOR_NEW: {
+        NodeId expr = nodes.child(node, 3);
+        int newCount = ++endNewCount;
+        return {
+            expr,
+            "add $1, $3, $0\n",
+            "lis $10\n.word new\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n",
+            CodeStep::later([newCount](ProcedureCode &out) {
+                LABEL(out, "bne $3, $0, ENDNEW", newCount, "\nadd $3, $11, $0\n");
+                LABEL(out, "ENDNEW", newCount);
+            }),
+        };
+    }
+    case Production::FACTOR_NULL:
+        return {"add $3, $11, $0\n"};
+    case Production::FACTOR_STAR: {
+        NodeId factor = nodes.child(node, 1);
+        return {factor, "lw $3, 0($3)\n"};
+    }
+    case Production::FACTOR_AMP: {
+        NodeId lvalue = nodes.child(node, 1);
+        if (getLvalueTerminal(lvalue) == Production::LVALUE_ID) {
+            int offset = getLvalueOffset(lvalue);
+            return {CodeStep::later([offset](ProcedureCode &out) { out << "lis $3\n.word " << offset << "\nadd $3, $29, $3\n"; })};
         }
-        if (lhs == "factor") {
-            if (rhs == "NEW INT LBRACK expr RBRACK") {
-                Node *expr = children[3].get();
-                endNewCount++;
-                return concatCode({
-                    expr->code(),
-                    "add $1, $3, $0\n",
-                    "lis $10\n.word new\nsw $31, -4($30)\nsub $30, $30, $4\njalr $10\nadd $30, $30, $4\nlw $31, -4($30)\n",
-                    "bne $3, $0, ENDNEW" + to_string(endNewCount) + "\nadd $3, $11, $0\nENDNEW" + to_string(endNewCount) + ":\n",
-                });
-            }
-            if (rhs == "NULL") {
-                return "add $3, $11, $0\n";
-            }
-            if (rhs == "STAR factor") {
-                Node *factor = children[1].get();
-                return concatCode({factor->code(), "lw $3, 0($3)\n"});
-            }
-            if (rhs == "AMP lvalue") {
-                Node *lvalue = children[1].get();
-                if (lvalue->getLvalueTerminal() == "ID") {
-                    int offset = lvalue->getLvalueOffset();
-                    return "lis $3\n.word " + to_string(offset) + "\nadd $3, $29, $3\n";
-                }
-                if (lvalue->getLvalueTerminal() == "STAR factor") {
-                    Node *factor = lvalue->children[1].get();
-                    return factor->code();
-                }
-            }
-            if (rhs == "ID LPAREN RPAREN") {
-                Node *ID = children[0].get();
-
-                string procTag = "P" + ID->rhs;
-                return concatCode({
-                    PUSH(29),
-                    PUSH(31),
-                    "lis $5\n.word " + procTag + "\njalr $5\n",
-                    POP(31),
-                    POP(29),
-                });
-            }
-            if (rhs == "ID LPAREN arglist RPAREN") {
-                Node *ID = children[0].get();
-                Node *arglist = children[2].get();
-                int argsCount = arglist->countArgs();
-
-                string procTag = "P" + ID->rhs;
-                string popArgs = "";
+        if (getLvalueTerminal(lvalue) == Production::LVALUE_STAR) {
+            NodeId factor = nodes.child(lvalue, 1);
+            return {factor};
+        }
+        break;
+    }
+    case Production::FACTOR_CALL: {
+        NodeId ID = nodes.child(node, 0);
+        return {
+            {PUSH, 29},
+            {PUSH, 31},
+            "lis $5\n.word P",
+            symbols.name(nodes.lexemes[ID]),
+            "\njalr $5\n",
+            {CALL, 0},
+            {POP, 31},
+            {POP, 29},
+        };
+    }
+    case Production::FACTOR_CALL_ARGS: {
+        NodeId ID = nodes.child(node, 0);
+        NodeId arglist = nodes.child(node, 2);
+        int argsCount = countArgs(arglist);
+        return {
+            {PUSH, 29},
+            {PUSH, 31},
+            arglist,
+            "lis $5\n.word P",
+            symbols.name(nodes.lexemes[ID]),
+            "\njalr $5\n",
+            {CALL, 0},
+            CodeStep::later([argsCount](ProcedureCode &out) {
                 for (int i = 0; i < argsCount; i++) {
-                    popArgs += POP(5);
+                    POP(out, 5);
                 }
-                return concatCode({
-                    PUSH(29),
-                    PUSH(31),
-                    arglist->code(),
-                    "lis $5\n.word " + procTag + "\njalr $5\n",
-                    popArgs,
-                    POP(31),
-                    POP(29),
-                });
-            }
-            if (rhs == "NUM") {
-                return children[0]->code();
-            }
-            if (rhs == "ID") {
-                Node *ID = children[0].get();
-                string IDStr = ID->rhs;
-                return GET_VARIABLE(IDStr);
-            }
-            if (rhs == "LPAREN expr RPAREN") {
-                return children[1]->code();
-            }
-            if (rhs == "GETCHAR LPAREN RPAREN") {
-                return "lis $5\n.word 0xffff0004\nlw $3, 0($5)\n";
+            }),
+            {POP, 31},
+            {POP, 29},
+        };
+    }
+    case Production::FACTOR_NUM:
+        return {nodes.child(node, 0)};
+    case Production::FACTOR_ID: {
+        NodeId ID = nodes.child(node, 0);
+        SymbolId lexeme = nodes.lexemes[ID];
+        int slot = nodes.slots[ID];
+        return {CodeStep::later([lexeme, slot](ProcedureCode &out) { GET_VARIABLE(out, lexeme, slot); })};
+    }
+    case Production::FACTOR_PARENS:
+        return {nodes.child(node, 1)};
+    case Production::FACTOR_GETCHAR:
+        return {"lis $5\n.word 0xffff0004\nlw $3, 0($5)\n"};
+    default:
+        break;
+    }
+    return {};
+}
+
+// Generates the subtree's code from an explicit stack of steps, so that
+// every step runs in output order, as the nested calls did. Each procedure
+// goes to `emitter` as soon as its registers are allocated.
+void generate(NodeId root, Emitter &emitter, Peephole &peephole) {
+    ProcedureCode out(emitter, peephole);
+    vector<CodeStep> pending{CodeStep(root)};
+    while (!pending.empty()) {
+        CodeStep step = move(pending.back());
+        pending.pop_back();
+        if (step.node != NO_NODE) {
+            vector<CodeStep> steps = code(step.node, step.arg);
+            for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+                pending.push_back(move(*it));
             }
+        } else if (step.emit != nullptr) {
+            step.emit(out, step.arg);
+        } else if (step.deferred) {
+            step.deferred(out);
+        } else {
+            out << step.text;
         }
-        return "";
     }
-};
+}
 
-int main() {
-    Node root{"start"};
-    root.populate(std::cin);
-    std::cout << root.code() << std::endl;
+// usage: wlp4gen [--binary] [--stats]
+// --binary reads the binary tree format in common/wlp4tree.h.
+// --stats prints how many instructions each peephole rule removed to stderr.
+int main(int argc, char *argv[]) {
+    std::ios::sync_with_stdio(false);
+    bool binary = false;
+    bool stats = false;
+    for (int i = 1; i < argc; ++i) {
+        string_view arg(argv[i]);
+        binary |= arg == "--binary";
+        stats |= arg == "--stats";
+    }
+    bool wellFormed;
+    if (binary) {
+        TreeReader reader(std::cin, symbols);
+        wellFormed = populate(reader) && reader.ok();
+    } else {
+        TextTreeReader reader(STDIN_FILENO);
+        if (!reader.readable()) {
+            outputError("cannot read standard input");
+            return 1;
+        }
+        wellFormed = populate(reader);
+        if (wellFormed) {
+            resolveSlots();
+        }
+    }
+    if (!wellFormed) {
+        outputError("malformed parse tree");
+        return 0;
+    }
+    Emitter out(STDOUT_FILENO);
+    Peephole peephole;
+    generate(0, out, peephole);
+    out << "\n";
+    if (stats) {
+        for (size_t rule = 0; rule < PEEPHOLE_RULE_COUNT; ++rule) {
+            std::cerr << PEEPHOLE_RULES[rule].name << " " << peephole.removed()[rule] << std::endl;
+        }
+    }
 }
@@ -0,0 +1,549 @@
+// A peephole optimizer over the generated MIPS: the assembly is read back
+// into a structured instruction list, a table of rules rewrites it, and the
+// result is written out in the same text format.
+#ifndef WLP4_PEEPHOLE_H
+#define WLP4_PEEPHOLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+enum class MipsOp : uint8_t {
+    ADD, SUB, SLT, SLTU,     // $d, $s, $t
+    MULT, MULTU, DIV, DIVU,  // $s, $t
+    MFHI, MFLO,              // $d
+    LIS,                     // $d, then .word `word`
+    LW, SW,                  // $t, offset($s)
+    BEQ, BNE,                // $s, $t, `word`
+    JR, JALR,                // $s
+    LABEL,                   // `word`:
+    OTHER,                   // any other line, `word`, kept as it is
+};
+
+inline constexpr std::array<std::string_view, 17> MIPS_MNEMONICS = {
+    "add", "sub", "slt", "sltu", "mult", "multu", "div", "divu", "mfhi",
+    "mflo", "lis", "lw", "sw", "beq", "bne", "jr", "jalr"};
+
+struct MipsInstr {
+    MipsOp op = MipsOp::OTHER;
+    uint8_t d = 0;
+    uint8_t s = 0;
+    uint8_t t = 0;
+    int32_t offset = 0;    // lw, sw
+    std::string_view word; // a view into the text the code was read from
+};
+
+// An instruction on $d, $s and $t.
+inline MipsInstr mipsInstr(MipsOp op, int d, int s, int t) {
+    MipsInstr instr;
+    instr.op = op;
+    instr.d = static_cast<uint8_t>(d);
+    instr.s = static_cast<uint8_t>(s);
+    instr.t = static_cast<uint8_t>(t);
+    return instr;
+}
+
+// lw or sw $t, offset($s).
+inline MipsInstr mipsMemory(MipsOp op, int t, int32_t offset, int s) {
+    MipsInstr instr = mipsInstr(op, 0, s, t);
+    instr.offset = offset;
+    return instr;
+}
+
+namespace peephole {
+
+// Reads the operands of one line left to right. Spaces and commas between
+// them are skipped.
+struct OperandReader {
+    std::string_view line;
+    std::size_t at = 0;
+
+    void skip() {
+        while (at < line.size() && (line[at] == ' ' || line[at] == ',')) {
+            ++at;
+        }
+    }
+    bool done() {
+        skip();
+        return at == line.size();
+    }
+    bool expect(char c) {
+        if (at < line.size() && line[at] == c) {
+            ++at;
+            return true;
+        }
+        return false;
+    }
+    // "$n" for n in 0-31.
+    bool reg(uint8_t &reg) {
+        skip();
+        if (!expect('$')) {
+            return false;
+        }
+        std::size_t start = at;
+        int value = 0;
+        while (at < line.size() && at - start < 2 && line[at] >= '0' && line[at] <= '9') {
+            value = value * 10 + (line[at++] - '0');
+        }
+        reg = static_cast<uint8_t>(value);
+        return at > start && value < 32;
+    }
+    bool number(int32_t &number) {
+        skip();
+        bool negative = expect('-');
+        std::size_t start = at;
+        int64_t value = 0;
+        while (at < line.size() && line[at] >= '0' && line[at] <= '9' && value <= INT32_MAX) {
+            value = value * 10 + (line[at++] - '0');
+        }
+        number = static_cast<int32_t>(negative ? -value : value);
+        return at > start && value <= INT32_MAX;
+    }
+    std::string_view word() {
+        skip();
+        std::size_t start = at;
+        at = line.size();
+        return line.substr(start);
+    }
+};
+
+// Splits off the first line of `text`.
+inline std::string_view nextLine(std::string_view &text) {
+    std::size_t newline = text.find('\n');
+    std::string_view line = text.substr(0, newline);
+    text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+    return line;
+}
+
+// One line, with `rest` the text after it, from which a lis takes its .word
+// line. Anything that does not parse is kept as an OTHER line.
+inline MipsInstr parseLine(std::string_view line, std::string_view &rest) {
+    MipsInstr instr;
+    instr.word = line;
+    if (!line.empty() && line.back() == ':') {
+        instr.op = MipsOp::LABEL;
+        instr.word = line.substr(0, line.size() - 1);
+        return instr;
+    }
+    std::string_view mnemonic = line.substr(0, line.find(' '));
+    std::size_t code = 0;
+    while (code < MIPS_MNEMONICS.size() && MIPS_MNEMONICS[code] != mnemonic) {
+        ++code;
+    }
+    OperandReader in{line, mnemonic.size()};
+    MipsOp op = static_cast<MipsOp>(code);
+    bool parsed = false;
+    switch (op) {
+    case MipsOp::ADD:
+    case MipsOp::SUB:
+    case MipsOp::SLT:
+    case MipsOp::SLTU:
+        parsed = in.reg(instr.d) && in.reg(instr.s) && in.reg(instr.t) && in.done();
+        break;
+    case MipsOp::MULT:
+    case MipsOp::MULTU:
+    case MipsOp::DIV:
+    case MipsOp::DIVU:
+        parsed = in.reg(instr.s) && in.reg(instr.t) && in.done();
+        break;
+    case MipsOp::MFHI:
+    case MipsOp::MFLO:
+        parsed = in.reg(instr.d) && in.done();
+        break;
+    case MipsOp::LIS:
+        parsed = in.reg(instr.d) && in.done() && rest.starts_with(".word ");
+        if (parsed) {
+            instr.word = nextLine(rest).substr(6);
+        }
+        break;
+    case MipsOp::LW:
+    case MipsOp::SW:
+        parsed = in.reg(instr.t) && in.number(instr.offset) && in.expect('(') && in.reg(instr.s) && in.expect(')') &&
+                 in.done();
+        break;
+    case MipsOp::BEQ:
+    case MipsOp::BNE:
+        parsed = in.reg(instr.s) && in.reg(instr.t) && !in.done();
+        if (parsed) {
+            instr.word = in.word();
+        }
+        break;
+    case MipsOp::JR:
+    case MipsOp::JALR:
+        parsed = in.reg(instr.s) && in.done();
+        break;
+    default:
+        break;
+    }
+    if (parsed) {
+        instr.op = op;
+    }
+    return instr;
+}
+
+} // namespace peephole
+
+// Reads assembly, one instruction, label or directive per line, as the code
+// generator writes it, onto the end of `code`. The instructions keep views
+// into `text`.
+inline void parseAssembly(std::string_view text, std::vector<MipsInstr> &code) {
+    while (!text.empty()) {
+        std::string_view line = peephole::nextLine(text);
+        code.push_back(peephole::parseLine(line, text));
+    }
+}
+
+// Writes one instruction as a line of assembly to anything with << for
+// string_view and int.
+template <typename Out>
+void writeInstr(Out &out, const MipsInstr &instr) {
+    std::string_view mnemonic;
+    if (instr.op < MipsOp::LABEL) {
+        mnemonic = MIPS_MNEMONICS[static_cast<std::size_t>(instr.op)];
+    }
+    switch (instr.op) {
+    case MipsOp::ADD:
+    case MipsOp::SUB:
+    case MipsOp::SLT:
+    case MipsOp::SLTU:
+        out << mnemonic << " $" << instr.d << ", $" << instr.s << ", $" << instr.t << "\n";
+        break;
+    case MipsOp::MULT:
+    case MipsOp::MULTU:
+    case MipsOp::DIV:
+    case MipsOp::DIVU:
+        out << mnemonic << " $" << instr.s << ", $" << instr.t << "\n";
+        break;
+    case MipsOp::MFHI:
+    case MipsOp::MFLO:
+        out << mnemonic << " $" << instr.d << "\n";
+        break;
+    case MipsOp::LIS:
+        out << "lis $" << instr.d << "\n.word " << instr.word << "\n";
+        break;
+    case MipsOp::LW:
+    case MipsOp::SW:
+        out << mnemonic << " $" << instr.t << ", " << instr.offset << "($" << instr.s << ")\n";
+        break;
+    case MipsOp::BEQ:
+    case MipsOp::BNE:
+        out << mnemonic << " $" << instr.s << ", $" << instr.t << ", " << instr.word << "\n";
+        break;
+    case MipsOp::JR:
+    case MipsOp::JALR:
+        out << mnemonic << " $" << instr.s << "\n";
+        break;
+    case MipsOp::LABEL:
+        out << instr.word << ":\n";
+        break;
+    case MipsOp::OTHER:
+        out << instr.word << "\n";
+        break;
+    }
+}
+
+namespace peephole {
+
+// What the rules may assume about the code around them:
+//  - only labels are branched to, so straight-line code between them runs
+//    in order;
+//  - memory at or below the stack pointer, -4($30) and down, is dead;
+//  - a call through $10 goes to the runtime, which reads $1 and $2, returns
+//    in $3 and leaves every other register alone;
+//  - any other call, and a return, may read any register.
+inline constexpr std::size_t LOOKAHEAD = 32;
+inline constexpr std::size_t LOOKBEHIND = 64;
+inline constexpr int RUNTIME_CALL_REG = 10;
+
+inline bool isAlu(MipsOp op) {
+    return op <= MipsOp::SLTU;
+}
+
+// The register an instruction sets, or -1. A call sets $31; what else it
+// sets is up to the callee.
+inline int written(const MipsInstr &instr) {
+    switch (instr.op) {
+    case MipsOp::ADD:
+    case MipsOp::SUB:
+    case MipsOp::SLT:
+    case MipsOp::SLTU:
+    case MipsOp::MFHI:
+    case MipsOp::MFLO:
+    case MipsOp::LIS:
+        return instr.d;
+    case MipsOp::LW:
+        return instr.t;
+    case MipsOp::JALR:
+        return 31;
+    default:
+        return -1;
+    }
+}
+
+inline bool reads(const MipsInstr &instr, int reg) {
+    switch (instr.op) {
+    case MipsOp::ADD:
+    case MipsOp::SUB:
+    case MipsOp::SLT:
+    case MipsOp::SLTU:
+    case MipsOp::MULT:
+    case MipsOp::MULTU:
+    case MipsOp::DIV:
+    case MipsOp::DIVU:
+    case MipsOp::SW:
+    case MipsOp::BEQ:
+    case MipsOp::BNE:
+        return instr.s == reg || instr.t == reg;
+    case MipsOp::LW:
+    case MipsOp::JR:
+        return instr.s == reg;
+    case MipsOp::JALR:
+        return instr.s != RUNTIME_CALL_REG || reg == 1 || reg == 2 || reg == RUNTIME_CALL_REG;
+    case MipsOp::MFHI:
+    case MipsOp::MFLO:
+    case MipsOp::LIS:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// Whether `reg`'s value is never read again, judged from the instructions
+// that follow up to the first label or control transfer.
+inline bool deadAfter(int reg, std::span<const MipsInstr> ahead) {
+    for (std::size_t i = 0; i < ahead.size() && i < LOOKAHEAD; ++i) {
+        const MipsInstr &instr = ahead[i];
+        bool runtimeCall = instr.op == MipsOp::JALR && instr.s == RUNTIME_CALL_REG;
+        if (reads(instr, reg) || instr.op == MipsOp::LABEL || instr.op == MipsOp::BEQ || instr.op == MipsOp::BNE ||
+            instr.op == MipsOp::JR || (instr.op == MipsOp::JALR && !runtimeCall)) {
+            return false;
+        }
+        if (written(instr) == reg || (runtimeCall && reg == 3)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// `add $d, $s, $0` or `add $d, $0, $s`: the register copied, else -1.
+inline int copiedFrom(const MipsInstr &instr) {
+    if (instr.op != MipsOp::ADD) {
+        return -1;
+    }
+    if (instr.t == 0) {
+        return instr.s;
+    }
+    return instr.s == 0 ? instr.t : -1;
+}
+
+inline MipsInstr copy(int to, int from) {
+    return mipsInstr(MipsOp::ADD, to, from, 0);
+}
+
+inline bool isStackAdjust(const MipsInstr &instr, MipsOp op) {
+    return instr.op == op && instr.d == 30 && instr.s == 30 && instr.t == 4;
+}
+
+inline bool isTopOfStack(const MipsInstr &instr, MipsOp op) {
+    return instr.op == op && instr.s == 30 && instr.offset == -4;
+}
+
+// Each rule looks at the last `length` instructions of `code`, with `ahead`
+// the instructions still to come, and rewrites them in place if they match.
+
+// sw $A, -4($30); sub $30, $30, $4; add $30, $30, $4; lw $B, -4($30)
+//   -> add $B, $A, $0
+inline bool pushPop(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    const MipsInstr *tail = &code[code.size() - 4];
+    if (!isTopOfStack(tail[0], MipsOp::SW) || !isStackAdjust(tail[1], MipsOp::SUB) ||
+        !isStackAdjust(tail[2], MipsOp::ADD) || !isTopOfStack(tail[3], MipsOp::LW)) {
+        return false;
+    }
+    int from = tail[0].t;
+    int to = tail[3].t;
+    code.resize(code.size() - 4);
+    if (from != to) {
+        code.push_back(copy(to, from));
+    }
+    return true;
+}
+
+// add $30, $30, $4; lw $A, -4($30); add $30, $30, $4; lw $A, -4($30)
+//   -> add $30, $30, $4; add $30, $30, $4; lw $A, -4($30)
+inline bool popPop(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    MipsInstr *tail = &code[code.size() - 4];
+    if (!isStackAdjust(tail[0], MipsOp::ADD) || !isTopOfStack(tail[1], MipsOp::LW) ||
+        !isStackAdjust(tail[2], MipsOp::ADD) || !isTopOfStack(tail[3], MipsOp::LW) || tail[1].t != tail[3].t) {
+        return false;
+    }
+    tail[1] = tail[2];
+    tail[2] = tail[3];
+    code.pop_back();
+    return true;
+}
+
+// sw $A, K($S); lw $B, K($S), in the frame -> sw $A, K($S); add $B, $A, $0,
+// or nothing for the lw if B is A.
+inline bool storeLoad(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    MipsInstr *tail = &code[code.size() - 2];
+    if (tail[0].op != MipsOp::SW || tail[1].op != MipsOp::LW || tail[0].s != tail[1].s ||
+        tail[0].offset != tail[1].offset || (tail[0].s != 29 && tail[0].s != 30) || tail[1].t == tail[0].s) {
+        return false;
+    }
+    if (tail[0].t == tail[1].t) {
+        code.pop_back();
+    } else {
+        tail[1] = copy(tail[1].t, tail[0].t);
+    }
+    return true;
+}
+
+// beq $S, $T, L; any labels; L: -> any labels; L:
+inline bool branchToNext(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    std::string_view label = code.back().word;
+    if (code.back().op != MipsOp::LABEL) {
+        return false;
+    }
+    std::size_t i = code.size() - 1;
+    while (i > 0 && code[i - 1].op == MipsOp::LABEL) {
+        --i;
+    }
+    if (i == 0 || (code[i - 1].op != MipsOp::BEQ && code[i - 1].op != MipsOp::BNE) || code[i - 1].word != label) {
+        return false;
+    }
+    code.erase(code.begin() + (i - 1));
+    return true;
+}
+
+// add $A, $A, $0 -> nothing
+inline bool selfCopy(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    if (copiedFrom(code.back()) != code.back().d) {
+        return false;
+    }
+    code.pop_back();
+    return true;
+}
+
+// lis $A; .word W, with $A still holding W from an earlier lis -> nothing
+inline bool reloadConstant(std::vector<MipsInstr> &code, std::span<const MipsInstr>) {
+    const MipsInstr &load = code.back();
+    if (load.op != MipsOp::LIS) {
+        return false;
+    }
+    std::size_t stop = code.size() > LOOKBEHIND ? code.size() - LOOKBEHIND : 0;
+    for (std::size_t i = code.size() - 1; i-- > stop;) {
+        const MipsInstr &instr = code[i];
+        if (instr.op == MipsOp::LIS && instr.d == load.d) {
+            if (instr.word != load.word) {
+                return false;
+            }
+            code.pop_back();
+            return true;
+        }
+        bool runtimeCall = instr.op == MipsOp::JALR && instr.s == RUNTIME_CALL_REG;
+        if (instr.op == MipsOp::LABEL || instr.op == MipsOp::OTHER || instr.op == MipsOp::JR ||
+            (instr.op == MipsOp::JALR && !runtimeCall) || written(instr) == load.d || (runtimeCall && load.d == 3)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// add $T, $R, $0; X reading $T, with $T dead after X -> X reading $R
+inline bool forwardCopy(std::vector<MipsInstr> &code, std::span<const MipsInstr> ahead) {
+    MipsInstr *tail = &code[code.size() - 2];
+    int from = copiedFrom(tail[0]);
+    int to = tail[0].d;
+    MipsInstr &user = tail[1];
+    bool plain = isAlu(user.op) || (user.op >= MipsOp::MULT && user.op <= MipsOp::DIVU) || user.op == MipsOp::LW ||
+                 user.op == MipsOp::SW;
+    if (from < 0 || to == 0 || to == from || !plain || !reads(user, to) ||
+        (written(user) != to && !deadAfter(to, ahead))) {
+        return false;
+    }
+    if (user.s == to) {
+        user.s = from;
+    }
+    if (user.t == to && user.op != MipsOp::LW) {
+        user.t = from;
+    }
+    tail[0] = user;
+    code.pop_back();
+    return true;
+}
+
+// X setting $T; add $R, $T, $0, with $T dead after -> X setting $R
+inline bool retarget(std::vector<MipsInstr> &code, std::span<const MipsInstr> ahead) {
+    MipsInstr *tail = &code[code.size() - 2];
+    int from = copiedFrom(tail[1]);
+    int to = tail[1].d;
+    MipsInstr &setter = tail[0];
+    bool plain = isAlu(setter.op) || setter.op == MipsOp::MFHI || setter.op == MipsOp::MFLO ||
+                 setter.op == MipsOp::LIS || setter.op == MipsOp::LW;
+    if (from <= 0 || to == 0 || to == from || !plain || written(setter) != from || !deadAfter(from, ahead)) {
+        return false;
+    }
+    if (setter.op == MipsOp::LW) {
+        setter.t = to;
+    } else {
+        setter.d = to;
+    }
+    code.pop_back();
+    return true;
+}
+
+} // namespace peephole
+
+struct PeepholeRule {
+    std::string_view name;
+    std::size_t length; // instructions matched at the end of the code so far
+    MipsOp last;        // the op of the last of them; OTHER for any
+    bool (*apply)(std::vector<MipsInstr> &code, std::span<const MipsInstr> ahead);
+};
+
+inline constexpr PeepholeRule PEEPHOLE_RULES[] = {
+    {"push-pop", 4, MipsOp::LW, peephole::pushPop},
+    {"pop-pop", 4, MipsOp::LW, peephole::popPop},
+    {"store-load", 2, MipsOp::LW, peephole::storeLoad},
+    {"branch-to-next", 2, MipsOp::LABEL, peephole::branchToNext},
+    {"self-copy", 1, MipsOp::ADD, peephole::selfCopy},
+    {"reload-constant", 1, MipsOp::LIS, peephole::reloadConstant},
+    {"forward-copy", 2, MipsOp::OTHER, peephole::forwardCopy},
+    {"retarget", 2, MipsOp::ADD, peephole::retarget},
+};
+inline constexpr std::size_t PEEPHOLE_RULE_COUNT = std::size(PEEPHOLE_RULES);
+
+// Runs the rules over code as it is appended, so each rewrite is matched
+// again against what came before it, and counts what each rule removed.
+class Peephole {
+    std::array<std::size_t, PEEPHOLE_RULE_COUNT> counts{};
+
+public:
+    // Leaves the optimized `code` in `done`.
+    void optimize(const std::vector<MipsInstr> &code, std::vector<MipsInstr> &done) {
+        done.clear();
+        std::span<const MipsInstr> all(code);
+        for (std::size_t next = 0; next < code.size(); ++next) {
+            done.push_back(code[next]);
+            for (std::size_t rule = 0; rule < PEEPHOLE_RULE_COUNT;) {
+                const PeepholeRule &match = PEEPHOLE_RULES[rule];
+                std::size_t before = done.size();
+                if (done.size() >= match.length && (match.last == MipsOp::OTHER || match.last == done.back().op) &&
+                    match.apply(done, all.subspan(next + 1))) {
+                    counts[rule] += before - done.size();
+                    rule = 0;
+                } else {
+                    ++rule;
+                }
+            }
+        }
+    }
+    // Instructions removed by each rule, as in PEEPHOLE_RULES; lis and its
+    // .word count as one.
+    const std::array<std::size_t, PEEPHOLE_RULE_COUNT> &removed() const { return counts; }
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef WLP4_FLAT_TREE_H
+#define WLP4_FLAT_TREE_H
+
+#include "wlp4intern.h"
+#include "wlp4production.h"
+#include "wlp4tree.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A node of a FlatTree: its index in pre-order.
+typedef uint32_t NodeId;
+inline constexpr NodeId NO_NODE = UINT32_MAX;
+
+// A parse tree as parallel arrays indexed by node, in pre-order, so that
+// walks over it read memory in order. An inner node's first child is the
+// next node, and each node records where its subtree ends, which is where
+// its next sibling starts. `Type` is the stage's one-byte node type; a node
+// takes about 15 bytes in all.
+template <typename Type>
+class FlatTree {
+  struct Open {
+    NodeId node;
+    int remaining; // children not yet appended
+  };
+  std::vector<Open> open; // inner nodes whose subtrees are being appended
+
+public:
+  // Inner nodes have a production, leaves a leaf code and a lexeme.
+  std::vector<Production> rules;
+  std::vector<uint8_t> leafCodes;
+  std::vector<SymbolId> lexemes;
+  std::vector<Type> types;
+  std::vector<int32_t> slots; // ID leaves naming a variable, else -1
+  std::vector<NodeId> ends;   // one past the last node of the subtree
+
+  NodeId size() const { return static_cast<NodeId>(rules.size()); }
+  void reserve(std::size_t nodes) {
+    rules.reserve(nodes);
+    leafCodes.reserve(nodes);
+    lexemes.reserve(nodes);
+    types.reserve(nodes);
+    slots.reserve(nodes);
+    ends.reserve(nodes);
+  }
+  // true once a whole tree has been appended.
+  bool complete() const { return !rules.empty() && open.empty(); }
+
+  // Appends the next node in pre-order; an inner node's children, one per
+  // rhs symbol of its production, are the nodes appended after it.
+  NodeId append(Production rule, uint8_t leafCode, SymbolId lexeme, Type type, int slot = -1) {
+    NodeId node = size();
+    rules.push_back(rule);
+    leafCodes.push_back(leafCode);
+    lexemes.push_back(lexeme);
+    types.push_back(type);
+    slots.push_back(slot);
+    ends.push_back(node + 1);
+    int length = rule == Production::NONE ? 0 : productionRule(rule).length;
+    if (length > 0) {
+      open.push_back({node, length});
+      return node;
+    }
+    while (!open.empty() && --open.back().remaining == 0) {
+      ends[open.back().node] = size();
+      open.pop_back();
+    }
+    return node;
+  }
+  // Whether an inner node with `rule`, or a leaf with `leafCode` when rule
+  // is NONE, may be appended next: its symbol must be the one the open
+  // node's production has at that child, or `start` for the root. Readers
+  // check this so that walks can rely on each node's children.
+  bool fits(Production rule, uint8_t leafCode) const {
+    int symbol = rule != Production::NONE ? productionRule(rule).lhs : leafCode;
+    if (rule == Production::NONE && !WLP4_CFG.isTerminal(symbol)) {
+      return false;
+    }
+    if (open.empty()) {
+      return rules.empty() && symbol == productionRule(Production::START).lhs;
+    }
+    const GrammarRule &parent = productionRule(rules[open.back().node]);
+    return parent.rhs[parent.length - open.back().remaining] == symbol;
+  }
+  NodeId appendInner(Production rule, Type type) {
+    return append(rule, TREE_INNER, NO_SYMBOL, type);
+  }
+  NodeId appendLeaf(uint8_t leafCode, SymbolId lexeme, Type type, int slot = -1) {
+    return append(Production::NONE, leafCode, lexeme, type, slot);
+  }
+
+  bool is(NodeId node, TokenKind kind) const {
+    return leafCodes[node] == static_cast<uint8_t>(kind);
+  }
+  // The k-th child, found by skipping its older siblings' subtrees.
+  NodeId child(NodeId node, int k) const {
+    NodeId c = node + 1;
+    for (; k > 0; --k) {
+      c = ends[c];
+    }
+    return c;
+  }
+  int childCount(NodeId node) const {
+    return rules[node] == Production::NONE ? 0 : productionRule(rules[node]).length;
+  }
+};
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef WLP4_GRAMMAR_H
+#define WLP4_GRAMMAR_H
+
+#include "wlp4token.h"
+#include <string_view>
+
+// The WLP4 grammar, one "lhs rhs..." rule per line; .EMPTY marks an empty
+// right-hand side. Rule 0 is the augmented start rule. A rule's id is its
+// line number, which is what parse trees refer to.
+inline constexpr std::string_view WLP4_GRAMMAR = R"(start BOF procedures EOF
+procedures procedure procedures
+procedures main
+procedure INT ID LPAREN params RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE
+main INT WAIN LPAREN dcl COMMA dcl RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE
+params .EMPTY
+params paramlist
+paramlist dcl
+paramlist dcl COMMA paramlist
+type INT
+type INT STAR
+dcls .EMPTY
+dcls dcls dcl BECOMES NUM SEMI
+dcls dcls dcl BECOMES NULL SEMI
+dcl type ID
+statements .EMPTY
+statements statements statement
+statement lvalue BECOMES expr SEMI
+statement IF LPAREN test RPAREN LBRACE statements RBRACE ELSE LBRACE statements RBRACE
+statement WHILE LPAREN test RPAREN LBRACE statements RBRACE
+statement PRINTLN LPAREN expr RPAREN SEMI
+statement PUTCHAR LPAREN expr RPAREN SEMI
+statement DELETE LBRACK RBRACK expr SEMI
+test expr EQ expr
+test expr NE expr
+test expr LT expr
+test expr LE expr
+test expr GE expr
+test expr GT expr
+expr term
+expr expr PLUS term
+expr expr MINUS term
+term factor
+term term STAR factor
+term term SLASH factor
+term term PCT factor
+factor ID
+factor NUM
+factor NULL
+factor LPAREN expr RPAREN
+factor AMP lvalue
+factor STAR factor
+factor NEW INT LBRACK expr RBRACK
+factor GETCHAR LPAREN RPAREN
+factor ID LPAREN RPAREN
+factor ID LPAREN arglist RPAREN
+arglist expr
+arglist expr COMMA arglist
+lvalue ID
+lvalue STAR factor
+lvalue LPAREN lvalue RPAREN)";
+
+// Grammar symbols are small ids: the token kinds in TokenKind order, then
+// BOF, EOF and the .ACCEPT lookahead, then the nonterminals in order of
+// their first rule. A terminal's id is also its tree leaf code.
+inline constexpr int SYMBOL_BOF = TOKEN_KIND_COUNT;
+inline constexpr int SYMBOL_EOF = TOKEN_KIND_COUNT + 1;
+inline constexpr int SYMBOL_ACCEPT = TOKEN_KIND_COUNT + 2;
+inline constexpr int FIRST_NONTERMINAL = TOKEN_KIND_COUNT + 3;
+inline constexpr int MAX_SYMBOLS = 64;
+inline constexpr int MAX_RULES = 64;
+inline constexpr int MAX_RHS = 16;
+
+struct GrammarRule {
+  int lhs = 0;
+  int length = 0; // 0 for .EMPTY
+  int rhs[MAX_RHS] = {};
+  std::string_view text; // the rule's line in WLP4_GRAMMAR
+};
+
+struct Grammar {
+  int ruleCount = 0;
+  int symbolCount = FIRST_NONTERMINAL;
+  GrammarRule rules[MAX_RULES] = {};
+  std::string_view names[MAX_SYMBOLS] = {};
+
+  // -1 if `name` is not a symbol.
+  constexpr int find(std::string_view name) const {
+    for (int i = 0; i < symbolCount; ++i) {
+      if (names[i] == name) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  // The id of the rule written as `text` in WLP4_GRAMMAR, or -1.
+  constexpr int findRule(std::string_view text) const {
+    for (int i = 0; i < ruleCount; ++i) {
+      if (rules[i].text == text) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  constexpr bool isTerminal(int symbol) const { return symbol < FIRST_NONTERMINAL; }
+};
+
+// Splits text at a separator, skipping empty pieces.
+class GrammarReader {
+  std::string_view text;
+  std::size_t pos = 0;
+  char separator;
+public:
+  constexpr GrammarReader(std::string_view text, char separator) : text(text), separator(separator) {}
+  constexpr std::string_view next() {
+    while (pos < text.size() && text[pos] == separator) {
+      ++pos;
+    }
+    std::size_t start = pos;
+    while (pos < text.size() && text[pos] != separator) {
+      ++pos;
+    }
+    return text.substr(start, pos - start);
+  }
+};
+
+constexpr Grammar readGrammar(std::string_view text) {
+  Grammar grammar;
+  for (int i = 0; i < TOKEN_KIND_COUNT; ++i) {
+    grammar.names[i] = TOKEN_NAMES[i];
+  }
+  grammar.names[SYMBOL_BOF] = "BOF";
+  grammar.names[SYMBOL_EOF] = "EOF";
+  grammar.names[SYMBOL_ACCEPT] = ".ACCEPT";
+  // Nonterminals are exactly the symbols with rules, so name them first.
+  GrammarReader lhsLines(text, '\n');
+  for (std::string_view line = lhsLines.next(); !line.empty(); line = lhsLines.next()) {
+    std::string_view lhs = GrammarReader(line, ' ').next();
+    if (grammar.find(lhs) >= 0) {
+      if (grammar.isTerminal(grammar.find(lhs))) {
+        throw "a terminal has a rule";
+      }
+      continue;
+    }
+    if (grammar.symbolCount == MAX_SYMBOLS) {
+      throw "too many symbols";
+    }
+    grammar.names[grammar.symbolCount++] = lhs;
+  }
+  GrammarReader lines(text, '\n');
+  for (std::string_view line = lines.next(); !line.empty(); line = lines.next()) {
+    if (grammar.ruleCount == MAX_RULES) {
+      throw "too many rules";
+    }
+    GrammarRule &rule = grammar.rules[grammar.ruleCount++];
+    rule.text = line;
+    GrammarReader words(line, ' ');
+    rule.lhs = grammar.find(words.next());
+    for (std::string_view word = words.next(); !word.empty(); word = words.next()) {
+      if (word == ".EMPTY") {
+        continue;
+      }
+      int symbol = grammar.find(word);
+      if (symbol < 0) {
+        throw "rule uses an unknown symbol";
+      }
+      if (rule.length == MAX_RHS) {
+        throw "rule is too long";
+      }
+      rule.rhs[rule.length++] = symbol;
+    }
+  }
+  return grammar;
+}
+
+inline constexpr Grammar WLP4_CFG = readGrammar(WLP4_GRAMMAR);
+
+#endif
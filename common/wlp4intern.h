@@ -0,0 +1,106 @@
+#ifndef WLP4_INTERN_H
+#define WLP4_INTERN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Lexemes are interned once when a stage reads its input; from then on they
+// are compared and used as table keys by their 32-bit id. Ids are dense and
+// handed out in first-seen order.
+typedef uint32_t SymbolId;
+inline constexpr SymbolId NO_SYMBOL = UINT32_MAX;
+
+// An open-addressing hash set of ids over an append-only arena. Names are
+// copied into fixed blocks that are never moved or freed before the
+// interner, so the views returned by name() stay valid.
+class Interner {
+  static constexpr std::size_t BLOCK_SIZE = 1 << 16;
+  std::vector<std::unique_ptr<char[]>> blocks;
+  char *blockFree = nullptr;
+  std::size_t blockLeft = 0;
+  std::vector<std::string_view> names;
+  std::vector<uint32_t> hashes;
+  std::vector<SymbolId> slots;
+
+  // FNV-1a.
+  static uint32_t hash(std::string_view s) {
+    uint32_t h = 2166136261u;
+    for (char c : s) {
+      h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return h;
+  }
+  std::string_view store(std::string_view s) {
+    // The empty name needs no storage, and there may be no block yet.
+    if (s.empty()) {
+      return {};
+    }
+    if (s.size() > blockLeft) {
+      std::size_t size = s.size() > BLOCK_SIZE ? s.size() : BLOCK_SIZE;
+      blocks.emplace_back(new char[size]);
+      blockFree = blocks.back().get();
+      blockLeft = size;
+    }
+    std::memcpy(blockFree, s.data(), s.size());
+    std::string_view stored(blockFree, s.size());
+    blockFree += s.size();
+    blockLeft -= s.size();
+    return stored;
+  }
+  std::size_t slotOf(std::string_view s, uint32_t h) const {
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = h & mask;
+    while (slots[i] != NO_SYMBOL && (hashes[slots[i]] != h || names[slots[i]] != s)) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+  // Keeps the table at most half full.
+  void grow() {
+    std::vector<SymbolId> old(slots.size() * 2, NO_SYMBOL);
+    slots.swap(old);
+    std::size_t mask = slots.size() - 1;
+    for (SymbolId id : old) {
+      if (id == NO_SYMBOL) {
+        continue;
+      }
+      std::size_t i = hashes[id] & mask;
+      while (slots[i] != NO_SYMBOL) {
+        i = (i + 1) & mask;
+      }
+      slots[i] = id;
+    }
+  }
+public:
+  Interner() : slots(1024, NO_SYMBOL) {}
+  Interner(const Interner &) = delete;
+  Interner &operator=(const Interner &) = delete;
+
+  SymbolId intern(std::string_view s) {
+    uint32_t h = hash(s);
+    std::size_t i = slotOf(s, h);
+    if (slots[i] != NO_SYMBOL) {
+      return slots[i];
+    }
+    SymbolId id = static_cast<SymbolId>(names.size());
+    names.push_back(store(s));
+    hashes.push_back(h);
+    slots[i] = id;
+    if (names.size() * 2 > slots.size()) {
+      grow();
+    }
+    return id;
+  }
+  // NO_SYMBOL if `s` was never interned.
+  SymbolId find(std::string_view s) const {
+    return slots[slotOf(s, hash(s))];
+  }
+  std::string_view name(SymbolId id) const { return names[id]; }
+  std::size_t size() const { return names.size(); }
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef WLP4_JOBS_H
+#define WLP4_JOBS_H
+
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+// Reads the value of a stage's --jobs N option: a whole decimal number,
+// nothing before or after it. Returns false, leaving `jobs` alone, for a
+// missing (null) or malformed value.
+inline bool parseJobs(const char *text, unsigned &jobs) {
+  if (text == nullptr) {
+    return false;
+  }
+  const char *end = text + std::strlen(text);
+  unsigned value;
+  auto [rest, error] = std::from_chars(text, end, value);
+  if (error != std::errc() || rest != end || rest == text) {
+    return false;
+  }
+  jobs = value;
+  return true;
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef WLP4_PERFECT_HASH_H
+#define WLP4_PERFECT_HASH_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Perfect hashes over fixed sets of names, found at compile time: `Key`
+// packs a few characters and the length of a name into 32 bits, which are
+// multiplied by a constant and shifted down to `SlotBits` bits. The
+// multiplier is searched until no two names share a slot. Used for the
+// scanner's keywords, the binary tree's leaf names and the text tree's
+// rules.
+template <typename Value>
+struct PerfectHashEntry {
+  std::string_view name; // not empty
+  Value value;
+};
+
+template <int SlotBits, auto Key, typename Value>
+struct PerfectHash {
+  uint32_t multiplier = 0;
+  std::size_t maxLength = 0;
+  std::array<std::string_view, 1 << SlotBits> names{}; // empty if unused
+  std::array<Value, 1 << SlotBits> values{};
+
+  // `s` must be a name `Key` accepts.
+  constexpr uint32_t slot(std::string_view s) const {
+    return (Key(s) * multiplier) >> (32 - SlotBits);
+  }
+  // The value of `s`, or `missing` if it is not one of the names.
+  constexpr Value find(std::string_view s, Value missing) const {
+    uint32_t at = slot(s);
+    return names[at] == s ? values[at] : missing;
+  }
+};
+
+template <int SlotBits, auto Key, typename Value, std::size_t N>
+constexpr PerfectHash<SlotBits, Key, Value> buildPerfectHash(const std::array<PerfectHashEntry<Value>, N> &entries,
+                                                             Value missing) {
+  for (uint32_t multiplier = 0x9e3779b1; ; multiplier += 2) {
+    PerfectHash<SlotBits, Key, Value> table;
+    table.multiplier = multiplier;
+    table.values.fill(missing);
+    bool perfect = true;
+    for (std::size_t i = 0; i < N && perfect; ++i) {
+      uint32_t slot = table.slot(entries[i].name);
+      perfect = table.names[slot].empty();
+      table.names[slot] = entries[i].name;
+      table.values[slot] = entries[i].value;
+      table.maxLength = std::max(table.maxLength, entries[i].name.size());
+    }
+    if (perfect) {
+      return table;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef WLP4_PRODUCTION_H
+#define WLP4_PRODUCTION_H
+
+#include "wlp4grammar.h"
+#include "wlp4perfecthash.h"
+#include "wlp4tree.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The WLP4 productions, in WLP4_GRAMMAR order, so that a production's value
+// is its rule id. Stages tag each inner node with its production as the tree
+// is read and dispatch on it with a switch; leaves have none.
+enum class Production : uint8_t {
+  START,
+  PROCEDURES_MORE,
+  PROCEDURES_MAIN,
+  PROCEDURE,
+  MAIN,
+  PARAMS_EMPTY,
+  PARAMS_LIST,
+  PARAMLIST_DCL,
+  PARAMLIST_MORE,
+  TYPE_INT,
+  TYPE_INT_STAR,
+  DCLS_EMPTY,
+  DCLS_NUM,
+  DCLS_NULL,
+  DCL,
+  STATEMENTS_EMPTY,
+  STATEMENTS_MORE,
+  STATEMENT_ASSIGN,
+  STATEMENT_IF,
+  STATEMENT_WHILE,
+  STATEMENT_PRINTLN,
+  STATEMENT_PUTCHAR,
+  STATEMENT_DELETE,
+  TEST_EQ,
+  TEST_NE,
+  TEST_LT,
+  TEST_LE,
+  TEST_GE,
+  TEST_GT,
+  EXPR_TERM,
+  EXPR_PLUS,
+  EXPR_MINUS,
+  TERM_FACTOR,
+  TERM_STAR,
+  TERM_SLASH,
+  TERM_PCT,
+  FACTOR_ID,
+  FACTOR_NUM,
+  FACTOR_NULL,
+  FACTOR_PARENS,
+  FACTOR_AMP,
+  FACTOR_STAR,
+  FACTOR_NEW,
+  FACTOR_GETCHAR,
+  FACTOR_CALL,
+  FACTOR_CALL_ARGS,
+  ARGLIST_EXPR,
+  ARGLIST_MORE,
+  LVALUE_ID,
+  LVALUE_STAR,
+  LVALUE_PARENS,
+  NONE, // not a production; leaves
+};
+inline constexpr int PRODUCTION_COUNT = static_cast<int>(Production::NONE);
+
+constexpr bool productionsMatchGrammar() {
+  constexpr std::string_view texts[] = {
+    "start BOF procedures EOF",
+    "procedures procedure procedures",
+    "procedures main",
+    "procedure INT ID LPAREN params RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE",
+    "main INT WAIN LPAREN dcl COMMA dcl RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE",
+    "params .EMPTY",
+    "params paramlist",
+    "paramlist dcl",
+    "paramlist dcl COMMA paramlist",
+    "type INT",
+    "type INT STAR",
+    "dcls .EMPTY",
+    "dcls dcls dcl BECOMES NUM SEMI",
+    "dcls dcls dcl BECOMES NULL SEMI",
+    "dcl type ID",
+    "statements .EMPTY",
+    "statements statements statement",
+    "statement lvalue BECOMES expr SEMI",
+    "statement IF LPAREN test RPAREN LBRACE statements RBRACE ELSE LBRACE statements RBRACE",
+    "statement WHILE LPAREN test RPAREN LBRACE statements RBRACE",
+    "statement PRINTLN LPAREN expr RPAREN SEMI",
+    "statement PUTCHAR LPAREN expr RPAREN SEMI",
+    "statement DELETE LBRACK RBRACK expr SEMI",
+    "test expr EQ expr",
+    "test expr NE expr",
+    "test expr LT expr",
+    "test expr LE expr",
+    "test expr GE expr",
+    "test expr GT expr",
+    "expr term",
+    "expr expr PLUS term",
+    "expr expr MINUS term",
+    "term factor",
+    "term term STAR factor",
+    "term term SLASH factor",
+    "term term PCT factor",
+    "factor ID",
+    "factor NUM",
+    "factor NULL",
+    "factor LPAREN expr RPAREN",
+    "factor AMP lvalue",
+    "factor STAR factor",
+    "factor NEW INT LBRACK expr RBRACK",
+    "factor GETCHAR LPAREN RPAREN",
+    "factor ID LPAREN RPAREN",
+    "factor ID LPAREN arglist RPAREN",
+    "arglist expr",
+    "arglist expr COMMA arglist",
+    "lvalue ID",
+    "lvalue STAR factor",
+    "lvalue LPAREN lvalue RPAREN",
+  };
+  if (std::size(texts) != PRODUCTION_COUNT || WLP4_CFG.ruleCount != PRODUCTION_COUNT) {
+    return false;
+  }
+  for (int i = 0; i < PRODUCTION_COUNT; ++i) {
+    if (WLP4_CFG.findRule(texts[i]) != i) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(productionsMatchGrammar(), "Production does not match WLP4_GRAMMAR");
+
+constexpr const GrammarRule &productionRule(Production production) {
+  return WLP4_CFG.rules[static_cast<int>(production)];
+}
+
+// Perfect hash over the rule texts, keyed on the length and the characters
+// at 0, 10 and 11, which between them tell every two rules apart.
+inline constexpr int RULE_SLOT_BITS = 8;
+
+// `s` is not empty.
+constexpr uint32_t ruleTextKey(std::string_view s) {
+  auto at = [s](std::size_t i) { return static_cast<unsigned char>(s[i < s.size() ? i : s.size() - 1]); };
+  return at(0) << 24 | at(10) << 16 | at(11) << 8 | static_cast<uint32_t>(s.size() & 0xff);
+}
+
+constexpr std::array<PerfectHashEntry<Production>, PRODUCTION_COUNT> ruleTextEntries() {
+  std::array<PerfectHashEntry<Production>, PRODUCTION_COUNT> entries{};
+  for (int r = 0; r < PRODUCTION_COUNT; ++r) {
+    entries[r] = {WLP4_CFG.rules[r].text, static_cast<Production>(r)};
+  }
+  return entries;
+}
+inline constexpr auto ruleTextTable =
+    buildPerfectHash<RULE_SLOT_BITS, ruleTextKey>(ruleTextEntries(), Production::NONE);
+
+// The production written as `text`, an "lhs rhs..." line of WLP4_GRAMMAR, or
+// NONE.
+inline Production findProduction(std::string_view text) {
+  return text.empty() ? Production::NONE : ruleTextTable.find(text, Production::NONE);
+}
+
+// The grammar in the form the binary tree header records.
+inline std::vector<TreeRule> productionTreeRules() {
+  std::vector<TreeRule> rules;
+  for (int r = 0; r < WLP4_CFG.ruleCount; ++r) {
+    const GrammarRule &rule = WLP4_CFG.rules[r];
+    TreeRule treeRule{std::string(WLP4_CFG.names[rule.lhs]), {}};
+    for (int i = 0; i < rule.length; ++i) {
+      treeRule.rhs.emplace_back(WLP4_CFG.names[rule.rhs[i]]);
+    }
+    if (rule.length == 0) {
+      treeRule.rhs.emplace_back(".EMPTY");
+    }
+    rules.push_back(std::move(treeRule));
+  }
+  return rules;
+}
+
+// The production of each rule in a binary tree's header, by rule id; NONE
+// for a rule WLP4 does not have.
+inline std::vector<Production> treeProductions(const std::vector<TreeRule> &rules) {
+  std::vector<Production> productions;
+  for (const TreeRule &rule : rules) {
+    std::string line = rule.lhs;
+    for (const std::string &symbol : rule.rhs) {
+      line += " " + symbol;
+    }
+    productions.push_back(findProduction(line));
+  }
+  return productions;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef WLP4_SCOPE_H
+#define WLP4_SCOPE_H
+
+#include "wlp4intern.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The names declared in one scope, numbered by slot in declaration order.
+// Stages keep what they know about each name in flat arrays indexed by slot
+// and annotate uses with it, so a name is looked up once. An open-addressing
+// hash map from symbol id to slot.
+class ScopeTable {
+  std::vector<SymbolId> names; // by slot
+  std::vector<int> table;      // slots, -1 for empty
+
+  static uint32_t hash(SymbolId name) { return name * 2654435761u; }
+  std::size_t indexOf(SymbolId name) const {
+    std::size_t mask = table.size() - 1;
+    std::size_t i = hash(name) & mask;
+    while (table[i] >= 0 && names[table[i]] != name) {
+      i = (i + 1) & mask;
+    }
+    return i;
+  }
+  // Keeps the table at most half full.
+  void grow() {
+    std::vector<int> old(table.size() * 2, -1);
+    table.swap(old);
+    for (int slot : old) {
+      if (slot >= 0) {
+        table[indexOf(names[slot])] = slot;
+      }
+    }
+  }
+public:
+  ScopeTable() : table(16, -1) {}
+
+  // The new name's slot, or -1 if the name is already declared.
+  int declare(SymbolId name) {
+    std::size_t i = indexOf(name);
+    if (table[i] >= 0) {
+      return -1;
+    }
+    int slot = static_cast<int>(names.size());
+    names.push_back(name);
+    table[i] = slot;
+    if (names.size() * 2 > table.size()) {
+      grow();
+    }
+    return slot;
+  }
+  // -1 if `name` is not declared.
+  int find(SymbolId name) const { return table[indexOf(name)]; }
+  SymbolId name(int slot) const { return names[slot]; }
+  int size() const { return static_cast<int>(names.size()); }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef WLP4_SOURCE_H
+#define WLP4_SOURCE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A stage's whole input as one read-only buffer. Regular files are mapped;
+// pipes are read once into a single string, retrying interrupted reads.
+class Source {
+  const char *mapped = nullptr;
+  std::size_t mappedLength = 0;
+  std::string buffered;
+  std::string_view text;
+  bool readFailed = false;
+
+  bool map(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      return false;
+    }
+    mappedLength = st.st_size;
+    if (mappedLength == 0) {
+      return true;
+    }
+    void *addr = mmap(nullptr, mappedLength, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      mappedLength = 0;
+      return false;
+    }
+    madvise(addr, mappedLength, MADV_SEQUENTIAL);
+    mapped = static_cast<const char *>(addr);
+    text = std::string_view(mapped, mappedLength);
+    return true;
+  }
+  void readAll(int fd) {
+    char chunk[1 << 16];
+    for (;;) {
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if (n > 0) {
+        buffered.append(chunk, n);
+      } else if (n == 0) {
+        break;
+      } else if (errno != EINTR) {
+        readFailed = true;
+        break;
+      }
+    }
+    text = buffered;
+  }
+public:
+  Source(const Source &) = delete;
+  Source &operator=(const Source &) = delete;
+  // fd is not closed; a mapping stays valid after the descriptor goes away.
+  explicit Source(int fd) {
+    if (!map(fd)) {
+      readAll(fd);
+    }
+  }
+  ~Source() {
+    if (mapped != nullptr) {
+      munmap(const_cast<char *>(mapped), mappedLength);
+    }
+  }
+  std::string_view view() const { return text; }
+  // false if reading failed part way, in which case view() holds only what
+  // was read before the error.
+  bool ok() const { return !readFailed; }
+};
+
+#endif
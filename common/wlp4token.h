@@ -0,0 +1,179 @@
+#ifndef WLP4_TOKEN_H
+#define WLP4_TOKEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Token kinds shared by the scanner and the parser. The order is part of the
+// binary token stream format below.
+enum class TokenKind : uint8_t {
+  ID,
+  NUM,
+  LPAREN,
+  RPAREN,
+  LBRACE,
+  RBRACE,
+  RETURN,
+  IF,
+  ELSE,
+  WHILE,
+  PRINTLN,
+  PUTCHAR,
+  GETCHAR,
+  WAIN,
+  BECOMES,
+  INT,
+  EQ,
+  NE,
+  LT,
+  GT,
+  LE,
+  GE,
+  PLUS,
+  MINUS,
+  STAR,
+  SLASH,
+  PCT,
+  COMMA,
+  SEMI,
+  NEW,
+  DELETE,
+  LBRACK,
+  RBRACK,
+  AMP,
+  NULL_, // NULL is a macro
+  NONE,  // not a token
+};
+
+inline constexpr const char *TOKEN_NAMES[] = {
+  "ID", "NUM", "LPAREN", "RPAREN", "LBRACE", "RBRACE", "RETURN", "IF", "ELSE",
+  "WHILE", "PRINTLN", "PUTCHAR", "GETCHAR", "WAIN", "BECOMES", "INT", "EQ",
+  "NE", "LT", "GT", "LE", "GE", "PLUS", "MINUS", "STAR", "SLASH", "PCT",
+  "COMMA", "SEMI", "NEW", "DELETE", "LBRACK", "RBRACK", "AMP", "NULL",
+};
+inline constexpr int TOKEN_KIND_COUNT = static_cast<int>(TokenKind::NONE);
+
+// The lexeme of every kind except ID and NUM is fixed by the kind.
+inline constexpr const char *TOKEN_LEXEMES[] = {
+  "", "", "(", ")", "{", "}", "return", "if", "else",
+  "while", "println", "putchar", "getchar", "wain", "=", "int", "==",
+  "!=", "<", ">", "<=", ">=", "+", "-", "*", "/", "%",
+  ",", ";", "new", "delete", "[", "]", "&", "NULL",
+};
+
+inline constexpr bool hasFixedLexeme(TokenKind kind) {
+  return kind != TokenKind::ID && kind != TokenKind::NUM;
+}
+
+inline const char *tokenName(TokenKind kind) {
+  return TOKEN_NAMES[static_cast<int>(kind)];
+}
+
+// Unsigned LEB128, used for lengths and ids in the binary formats.
+inline void writeVarint(std::ostream &out, std::size_t value) {
+  while (value >= 0x80) {
+    out.put(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.put(static_cast<char>(value));
+}
+
+inline bool readVarint(std::istream &in, std::size_t &value) {
+  value = 0;
+  for (int shift = 0; shift <= 56; shift += 7) {
+    std::istream::int_type c = in.get();
+    if (c == std::istream::traits_type::eof()) {
+      return false;
+    }
+    value |= static_cast<std::size_t>(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads `length` bytes into `buffer` in pieces, so a corrupt length fails
+// at the end of the stream instead of being allocated up front.
+inline bool readBytes(std::istream &in, std::size_t length, std::string &buffer) {
+  buffer.clear();
+  while (length > 0) {
+    std::size_t piece = length < (1 << 16) ? length : (1 << 16);
+    std::size_t used = buffer.size();
+    buffer.resize(used + piece);
+    if (!in.read(buffer.data() + used, piece)) {
+      return false;
+    }
+    length -= piece;
+  }
+  return true;
+}
+
+// Binary token stream, selected with --binary in the scanner and parser.
+// The stream starts with TOKEN_STREAM_MAGIC, followed by one record per
+// token: a kind byte, then for ID and NUM the lexeme length as an unsigned
+// LEB128 varint and the lexeme bytes. Other kinds carry no lexeme.
+inline constexpr std::string_view TOKEN_STREAM_MAGIC = "WLP4TOK1";
+
+class TokenStreamWriter {
+  std::ostream &out;
+public:
+  // Pass header = false when appending to a stream that already has one.
+  explicit TokenStreamWriter(std::ostream &out, bool header = true) : out(out) {
+    if (header) {
+      out.write(TOKEN_STREAM_MAGIC.data(), TOKEN_STREAM_MAGIC.size());
+    }
+  }
+  void write(TokenKind kind, std::string_view lexeme) {
+    out.put(static_cast<char>(kind));
+    if (hasFixedLexeme(kind)) {
+      return;
+    }
+    writeVarint(out, lexeme.size());
+    out.write(lexeme.data(), lexeme.size());
+  }
+};
+
+// Decodes the stream incrementally, so memory use does not grow with it.
+class TokenStreamReader {
+  std::istream &in;
+  std::string lexemeBuffer;
+  bool valid;
+public:
+  explicit TokenStreamReader(std::istream &in) : in(in) {
+    char magic[TOKEN_STREAM_MAGIC.size()];
+    valid = in.read(magic, sizeof(magic)) && std::string_view(magic, sizeof(magic)) == TOKEN_STREAM_MAGIC;
+  }
+  // false once the stream ends or turns out to be malformed. An ID or NUM
+  // lexeme stays valid until the next call.
+  bool next(TokenKind &kind, std::string_view &lexeme) {
+    if (!valid) {
+      return false;
+    }
+    std::istream::int_type c = in.get();
+    if (c == std::istream::traits_type::eof()) {
+      return false;
+    }
+    kind = static_cast<TokenKind>(c);
+    if (kind >= TokenKind::NONE) {
+      return valid = false;
+    }
+    if (hasFixedLexeme(kind)) {
+      lexeme = TOKEN_LEXEMES[static_cast<int>(kind)];
+      return true;
+    }
+    std::size_t length;
+    if (!readVarint(in, length) || !readBytes(in, length, lexemeBuffer)) {
+      return valid = false;
+    }
+    lexeme = lexemeBuffer;
+    return true;
+  }
+  bool ok() const { return valid; }
+};
+
+#endif
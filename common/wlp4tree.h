@@ -0,0 +1,213 @@
+#ifndef WLP4_TREE_H
+#define WLP4_TREE_H
+
+#include "wlp4intern.h"
+#include "wlp4perfecthash.h"
+#include "wlp4token.h"
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Binary parse tree, selected with --binary in the parser, type checker and
+// code generator. The stream starts with TREE_MAGIC and the grammar: a rule
+// count, then each rule as a length-prefixed "lhs rhs..." line, so rule ids
+// mean the same thing to every reader. The nodes follow in pre-order, each
+// starting with a tag byte: the low six bits are TREE_INNER or a leaf code,
+// the top two a TreeType.
+//   inner node: tag, rule id. Its children, one per rhs symbol (none for
+//               an .EMPTY rule), follow.
+//   leaf:       tag, lexeme id. Lexemes are numbered in order of first use;
+//               the first use of an id is followed by its length and bytes.
+//               An ID leaf then has its variable's slot plus one, or 0 if
+//               it names no variable or has not been resolved.
+inline constexpr std::string_view TREE_MAGIC = "WLP4TRE2";
+
+enum class TreeType : uint8_t {
+  NONE,
+  INT,
+  PTR,
+};
+
+// Leaf codes are token kinds, plus BOF and EOF.
+inline constexpr uint8_t TREE_BOF = TOKEN_KIND_COUNT;
+inline constexpr uint8_t TREE_EOF = TOKEN_KIND_COUNT + 1;
+inline constexpr uint8_t TREE_INNER = 0x3f;
+
+constexpr std::string_view leafName(int code) {
+  return code < TOKEN_KIND_COUNT ? TOKEN_NAMES[code] : code == TREE_BOF ? "BOF" : "EOF";
+}
+
+// Perfect hash over the leaf names, keyed on the first two and the last
+// characters and the length. Names are at least two characters long.
+inline constexpr int LEAF_SLOT_BITS = 7;
+
+constexpr uint32_t leafNameKey(std::string_view s) {
+  return static_cast<unsigned char>(s[0]) << 24 | static_cast<unsigned char>(s[1]) << 16 |
+         static_cast<unsigned char>(s.back()) << 8 | static_cast<uint32_t>(s.size() & 0xff);
+}
+
+constexpr std::array<PerfectHashEntry<uint8_t>, TREE_EOF + 1> leafNameEntries() {
+  std::array<PerfectHashEntry<uint8_t>, TREE_EOF + 1> entries{};
+  for (int code = 0; code <= TREE_EOF; ++code) {
+    entries[code] = {leafName(code), static_cast<uint8_t>(code)};
+  }
+  return entries;
+}
+inline constexpr auto leafNameTable = buildPerfectHash<LEAF_SLOT_BITS, leafNameKey>(leafNameEntries(), TREE_INNER);
+
+// The leaf code of a terminal name, or TREE_INNER for any other symbol.
+inline uint8_t treeLeafCode(std::string_view name) {
+  return name.size() < 2 ? TREE_INNER : leafNameTable.find(name, TREE_INNER);
+}
+
+struct TreeRule {
+  std::string lhs;
+  std::vector<std::string> rhs;
+};
+
+class TreeWriter {
+  std::ostream &out;
+  Interner lexemes;
+
+  void tag(uint8_t code, TreeType type) {
+    out.put(static_cast<char>(code | static_cast<uint8_t>(type) << 6));
+  }
+public:
+  TreeWriter(std::ostream &out, const std::vector<TreeRule> &rules) : out(out) {
+    out.write(TREE_MAGIC.data(), TREE_MAGIC.size());
+    writeVarint(out, rules.size());
+    for (const TreeRule &rule : rules) {
+      std::string line = rule.lhs;
+      for (const std::string &symbol : rule.rhs) {
+        line += " " + symbol;
+      }
+      writeVarint(out, line.size());
+      out.write(line.data(), line.size());
+    }
+  }
+  void inner(int ruleId, TreeType type = TreeType::NONE) {
+    tag(TREE_INNER, type);
+    writeVarint(out, ruleId);
+  }
+  void leaf(uint8_t code, std::string_view lexeme, TreeType type = TreeType::NONE, int slot = -1) {
+    tag(code, type);
+    std::size_t known = lexemes.size();
+    SymbolId id = lexemes.intern(lexeme);
+    writeVarint(out, id);
+    if (id == known) {
+      writeVarint(out, lexeme.size());
+      out.write(lexeme.data(), lexeme.size());
+    }
+    if (code == static_cast<uint8_t>(TokenKind::ID)) {
+      writeVarint(out, slot + 1);
+    }
+  }
+};
+
+struct TreeRecord {
+  bool leaf;
+  int ruleId;       // inner nodes
+  uint8_t code;     // leaves
+  SymbolId lexeme;  // leaves, in the reader's interner
+  int slot;         // ID leaves; -1 if none
+  TreeType type;
+};
+
+// Reads nodes one at a time. Lexemes are interned into the caller's
+// interner, each once, on first use.
+class TreeReader {
+  std::istream &in;
+  Interner &symbols;
+  std::vector<TreeRule> ruleTable;
+  std::vector<SymbolId> lexemeIds;
+  std::string buffer;
+  bool valid;
+
+  bool readRules() {
+    char magic[TREE_MAGIC.size()];
+    if (!in.read(magic, sizeof(magic)) || std::string_view(magic, sizeof(magic)) != TREE_MAGIC) {
+      return false;
+    }
+    std::size_t count;
+    if (!readVarint(in, count)) {
+      return false;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      std::size_t length;
+      if (!readVarint(in, length) || !readBytes(in, length, buffer)) {
+        return false;
+      }
+      TreeRule rule;
+      std::string_view line = buffer;
+      while (!line.empty()) {
+        std::size_t space = line.find(' ');
+        std::string_view word = line.substr(0, space);
+        if (rule.lhs.empty()) {
+          rule.lhs = word;
+        } else {
+          rule.rhs.emplace_back(word);
+        }
+        line.remove_prefix(space == std::string_view::npos ? line.size() : space + 1);
+      }
+      ruleTable.push_back(std::move(rule));
+    }
+    return true;
+  }
+public:
+  TreeReader(std::istream &in, Interner &symbols) : in(in), symbols(symbols) {
+    valid = readRules();
+  }
+  const std::vector<TreeRule> &rules() const { return ruleTable; }
+  // false once the stream ends or turns out to be malformed.
+  bool next(TreeRecord &record) {
+    if (!valid) {
+      return false;
+    }
+    std::istream::int_type c = in.get();
+    if (c == std::istream::traits_type::eof()) {
+      return valid = false;
+    }
+    record.code = c & 0x3f;
+    record.type = static_cast<TreeType>(c >> 6);
+    record.leaf = record.code != TREE_INNER;
+    if (record.type > TreeType::PTR || (record.leaf && record.code > TREE_EOF)) {
+      return valid = false;
+    }
+    std::size_t id;
+    if (!readVarint(in, id)) {
+      return valid = false;
+    }
+    if (!record.leaf) {
+      record.ruleId = static_cast<int>(id);
+      return valid = id < ruleTable.size();
+    }
+    if (id == lexemeIds.size()) {
+      std::size_t length;
+      if (!readVarint(in, length) || !readBytes(in, length, buffer)) {
+        return valid = false;
+      }
+      lexemeIds.push_back(symbols.intern(buffer));
+    } else if (id > lexemeIds.size()) {
+      return valid = false;
+    }
+    record.lexeme = lexemeIds[id];
+    record.slot = -1;
+    if (record.code == static_cast<uint8_t>(TokenKind::ID)) {
+      std::size_t slot;
+      if (!readVarint(in, slot) || slot > INT_MAX) {
+        return valid = false;
+      }
+      record.slot = static_cast<int>(slot) - 1;
+    }
+    return true;
+  }
+  bool ok() const { return valid; }
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef WLP4_TREE_TEXT_H
+#define WLP4_TREE_TEXT_H
+
+#include "wlp4production.h"
+#include "wlp4source.h"
+#include "wlp4tree.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// One line of the text tree format: a rule, "lhs rhs...", or a leaf,
+// "KIND lexeme". Either may be followed by " : " and the node's type, as
+// the type checker prints it.
+struct TextTreeLine {
+  Production production;   // NONE for leaves
+  uint8_t code;            // leaves; TREE_INNER for inner nodes
+  std::string_view lexeme; // leaves; a view into the input
+  TreeType type;
+};
+
+// Reads the text tree format, one node per line in pre-order, from the
+// whole input as one buffer. Lines are split and classified in place, the
+// first word by the leaf name hash and a rule's line by the rule hash, so
+// nothing is copied or allocated per line.
+class TextTreeReader {
+  Source source;
+  const char *p;
+  const char *end;
+  bool valid = true;
+
+public:
+  // fd is not closed.
+  explicit TextTreeReader(int fd)
+      : source(fd), p(source.view().data()), end(source.view().data() + source.view().size()) {}
+  // false once the input ends, or at a line that is neither a leaf nor a
+  // WLP4 rule, after which ok() is false too. The lexeme stays valid for
+  // the reader's lifetime.
+  bool next(TextTreeLine &line) {
+    if (!valid || p == end) {
+      return false;
+    }
+    const char *newline = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    const char *lineEnd = newline != nullptr ? newline : end;
+    std::string_view text(p, lineEnd - p);
+    p = newline != nullptr ? newline + 1 : end;
+
+    // No lexeme or rule has a colon, so the first one starts the type.
+    line.type = TreeType::NONE;
+    std::size_t colon = text.find(':');
+    if (colon != std::string_view::npos && colon > 0 && text[colon - 1] == ' ') {
+      std::string_view typeName = text.substr(colon + 1);
+      while (!typeName.empty() && typeName.front() == ' ') {
+        typeName.remove_prefix(1);
+      }
+      typeName = typeName.substr(0, typeName.find(' '));
+      if (typeName == "int") {
+        line.type = TreeType::INT;
+      } else if (typeName == "int*") {
+        line.type = TreeType::PTR;
+      }
+      text = text.substr(0, colon - 1);
+    }
+    while (!text.empty() && text.back() == ' ') {
+      text.remove_suffix(1);
+    }
+    std::size_t space = text.find(' ');
+    line.code = treeLeafCode(text.substr(0, space));
+    if (line.code != TREE_INNER) {
+      std::string_view lexeme = space == std::string_view::npos ? "" : text.substr(space + 1);
+      line.production = Production::NONE;
+      line.lexeme = lexeme.substr(0, lexeme.find(' '));
+      return true;
+    }
+    line.production = findProduction(text);
+    line.lexeme = {};
+    return valid = line.production != Production::NONE;
+  }
+  // The number of lines left, an upper bound on the nodes still to come.
+  std::size_t linesLeft() const {
+    return std::count(p, end, '\n') + (p != end && end[-1] != '\n');
+  }
+  bool ok() const { return valid; }
+  // false if the input could not be read in full.
+  bool readable() const { return source.ok(); }
+};
+
+#endif
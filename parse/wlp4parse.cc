@@ -1,273 +1,769 @@
-#include "wlp4data.h"
+#include "../common/wlp4grammar.h"
+#include "../common/wlp4intern.h"
+#include "../common/wlp4jobs.h"
+#include "../common/wlp4production.h"
+#include "../common/wlp4token.h"
+#include "../common/wlp4tree.h"
+#include "../scanner/wlp4scanner.h"
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <new>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std;
-struct Rule {
-    string lhs;
-    vector<string> rhs;
-    bool nullable() {
-        return rhs.size() > 0 && rhs[0] == ".EMPTY";
-    };
-};
+
+// Lexemes are interned as tokens are read, so every later copy is a view.
+Interner lexemes;
+
+string_view internLexeme(string_view lexeme) {
+    return lexemes.name(lexemes.intern(lexeme));
+}
 
 enum class NodeType {
     Rule,
     leaf,
 };
 
+// Bump allocator for the parse tree. Nodes and their child arrays are cut
+// from large blocks and all released together with the arena, so only
+// trivially destructible objects may live in it.
+class Arena {
+    static constexpr size_t BLOCK_SIZE = 1 << 20;
+    vector<unique_ptr<char[]>> blocks;
+    char *next = nullptr;
+    size_t left = 0;
+
+    void *allocate(size_t size, size_t align) {
+        size_t padding = -reinterpret_cast<uintptr_t>(next) & (align - 1);
+        if (padding + size > left) {
+            size_t blockSize = max(size + align, BLOCK_SIZE);
+            blocks.emplace_back(new char[blockSize]);
+            next = blocks.back().get();
+            left = blockSize;
+            padding = -reinterpret_cast<uintptr_t>(next) & (align - 1);
+        }
+        void *p = next + padding;
+        next += padding + size;
+        left -= padding + size;
+        return p;
+    }
+
+public:
+    template <typename T, typename... Args>
+    T *make(Args &&...args) {
+        return new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+    }
+    template <typename T>
+    T *makeArray(size_t n) {
+        return static_cast<T *>(allocate(n * sizeof(T), alignof(T)));
+    }
+};
+
+// The lexeme a terminal's kind fixes, or an empty view for ID, NUM and
+// any other symbol.
+constexpr string_view fixedLexeme(int symbol) {
+    if (symbol == SYMBOL_BOF || symbol == SYMBOL_EOF) {
+        return WLP4_CFG.names[symbol];
+    }
+    if (symbol < TOKEN_KIND_COUNT && hasFixedLexeme(static_cast<TokenKind>(symbol))) {
+        return TOKEN_LEXEMES[symbol];
+    }
+    return {};
+}
+
+// A compact node's children are matched to its rule's rhs in order, a kept
+// leaf being told from a left-out one by its kind. That is unambiguous as
+// long as no rule repeats a fixed terminal with only fixed terminals between.
+constexpr bool fixedTerminalsDistinct(const Grammar &grammar) {
+    for (int r = 0; r < grammar.ruleCount; ++r) {
+        const GrammarRule &rule = grammar.rules[r];
+        for (int i = 0; i < rule.length; ++i) {
+            for (int j = i + 1; j < rule.length && !fixedLexeme(rule.rhs[i]).empty(); ++j) {
+                if (fixedLexeme(rule.rhs[j]).empty()) {
+                    break;
+                }
+                if (rule.rhs[j] == rule.rhs[i]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+static_assert(fixedTerminalsDistinct(WLP4_CFG), "compact trees cannot be expanded for this grammar");
+
+constexpr int MAX_UNITS = 4;
+
+// Inner nodes name their rule by its id in WLP4_CFG; leaves keep their
+// tree leaf code and view their interned lexeme.
+//
+// A compact tree (--compact) leaves out what the rules imply: leaves whose
+// lexeme is the one fixed by their kind, and the inner nodes of unit rules
+// like expr term or factor ID, which are recorded in `units` on the node
+// they wrap, innermost first. walk() puts both back.
 struct Node {
     NodeType type;
-    Rule rule;
-    string token;
-    string lexeme;
-    vector<unique_ptr<Node>> children;
+    uint8_t leafCode;
+    uint8_t unitCount = 0;
+    uint8_t units[MAX_UNITS];
+    int ruleId;
+    string_view lexeme;
+    Node **children;
+    int childCount;
 
 public:
-    Node(Rule &rule) : type(NodeType::Rule), rule(rule), token(""), lexeme("") {}
-    Node(const string &token, const string &lexeme) : type(NodeType::leaf), rule(Rule{}), token(token), lexeme(lexeme) {}
-    void addChild(unique_ptr<Node> child) { children.emplace_back(move(child)); }
-    void addChildren(vector<unique_ptr<Node>> &children) {
-        for (auto &child : children) {
-            this->children.emplace_back(move(child));
+    Node(int ruleId, Node **children, int childCount)
+        : type(NodeType::Rule), ruleId(ruleId), children(children), childCount(childCount) {}
+    Node(uint8_t leafCode, string_view lexeme)
+        : type(NodeType::leaf), leafCode(leafCode), ruleId(-1), lexeme(lexeme), children(nullptr), childCount(0) {}
+    // Walks the full parse tree in pre-order: leaf(code, lexeme) sees each
+    // leaf and inner(ruleId) each inner node. The walk keeps its own stack,
+    // since statements and procedures chains are as deep as the program is
+    // long.
+    template <typename Leaf, typename Inner>
+    void walk(Leaf leaf, Inner inner) {
+        // A left-out leaf of kind `symbol` if node is nullptr; otherwise
+        // node with `units` of its unit rules still to be shown.
+        struct Item {
+            Node *node;
+            int units;
+            int symbol;
+        };
+        vector<Item> pending{{this, unitCount, 0}};
+        while (!pending.empty()) {
+            Item item = pending.back();
+            pending.pop_back();
+            Node *node = item.node;
+            if (node == nullptr) {
+                leaf(item.symbol, fixedLexeme(item.symbol));
+            } else if (item.units > 0) {
+                inner(node->units[item.units - 1]);
+                pending.push_back({node, item.units - 1, 0});
+            } else if (node->type == NodeType::leaf) {
+                leaf(node->leafCode, node->lexeme);
+            } else {
+                inner(node->ruleId);
+                const GrammarRule &rule = WLP4_CFG.rules[node->ruleId];
+                size_t first = pending.size();
+                int kept = 0;
+                for (int i = 0; i < rule.length; ++i) {
+                    Node *child = kept < node->childCount ? node->children[kept] : nullptr;
+                    if (fixedLexeme(rule.rhs[i]).empty() ||
+                        (child != nullptr && child->type == NodeType::leaf && child->unitCount == 0 &&
+                         child->leafCode == rule.rhs[i])) {
+                        pending.push_back({child, child->unitCount, 0});
+                        ++kept;
+                    } else {
+                        pending.push_back({nullptr, 0, rule.rhs[i]});
+                    }
+                }
+                reverse(pending.begin() + first, pending.end());
+            }
         }
     }
     void print() {
-        if (type == NodeType::leaf) {
-            cout << token << " " << lexeme << endl;
-            return;
-        }
-        cout << rule.lhs << " ";
-        for (auto &rhs : rule.rhs) {
-            cout << rhs << " ";
-        }
-        cout << endl;
-        for (auto &child : children) {
-            child->print();
-        }
+        walk([](int code, string_view lexeme) { cout << WLP4_CFG.names[code] << " " << lexeme << "\n"; },
+             [](int ruleId) { cout << WLP4_CFG.rules[ruleId].text << " \n"; });
+    }
+    void write(TreeWriter &out) {
+        walk([&out](int code, string_view lexeme) { out.leaf(code, lexeme); },
+             [&out](int ruleId) { out.inner(ruleId); });
     }
 };
 
-struct Tree {
-    unique_ptr<Node> root;
-    void print() { root->print(); }
-};
+// ACTION and GOTO share one flat [state][symbol] table. A cell holds 0 for
+// an error, s + 1 to shift (or, on a nonterminal, go) to state s, and
+// -(r + 1) to reduce by rule r. The last column, past every grammar symbol,
+// is all errors.
+typedef int16_t Action;
 
-struct Transition {
-    int fromState;
-    int toState;
-    string symbol;
+constexpr int COLUMNS = WLP4_CFG.symbolCount + 1;
+constexpr int MAX_LR_ITEMS = 256;
+constexpr int MAX_LR_STATES = 256;
+
+// A set of LR(0) items. Items are numbered rule by rule: rule r with the dot
+// before rhs[d] is item itemStart[r] + d.
+struct ItemSet {
+    uint64_t words[MAX_LR_ITEMS / 64] = {};
+
+    constexpr void add(int item) { words[item / 64] |= uint64_t(1) << item % 64; }
+    constexpr bool has(int item) const { return words[item / 64] >> item % 64 & 1; }
+    constexpr bool merge(const ItemSet &other) {
+        bool changed = false;
+        for (int i = 0; i < MAX_LR_ITEMS / 64; ++i) {
+            changed |= (other.words[i] & ~words[i]) != 0;
+            words[i] |= other.words[i];
+        }
+        return changed;
+    }
+    constexpr bool empty() const {
+        for (int i = 0; i < MAX_LR_ITEMS / 64; ++i) {
+            if (words[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    constexpr bool operator==(const ItemSet &) const = default;
 };
 
-struct Reduction {
-    int state;
-    int ruleId;
-    string symbol;
+struct SLRTables {
+    int stateCount = 0;
+    int conflicts = 0;
+    Action actions[MAX_LR_STATES * COLUMNS] = {};
 };
 
-class CFG {
-    vector<Rule> rules;
+// Builds the LR(0) automaton of the grammar and its SLR(1) table: a state
+// reduces by a complete item on the terminals in FOLLOW of the item's lhs,
+// and rule 0 is reduced on .ACCEPT once the input has ended. Cells claimed
+// twice are counted as conflicts, and the reduction is kept.
+constexpr SLRTables buildSLR(const Grammar &grammar) {
+    int itemStart[MAX_RULES + 1] = {};
+    int itemRule[MAX_LR_ITEMS] = {};
+    for (int r = 0; r < grammar.ruleCount; ++r) {
+        itemStart[r + 1] = itemStart[r] + grammar.rules[r].length + 1;
+        if (itemStart[r + 1] > MAX_LR_ITEMS) {
+            throw "too many items";
+        }
+        for (int item = itemStart[r]; item < itemStart[r + 1]; ++item) {
+            itemRule[item] = r;
+        }
+    }
+    int itemCount = itemStart[grammar.ruleCount];
+    // The symbol after the dot, or -1 for a complete item.
+    auto after = [&](int item) {
+        const GrammarRule &rule = grammar.rules[itemRule[item]];
+        int dot = item - itemStart[itemRule[item]];
+        return dot < rule.length ? rule.rhs[dot] : -1;
+    };
 
-public:
-    void reduce(int id, vector<string> &redSeq) {
-        Rule &rule = getRuleById(id);
-        if (rule.nullable()) {
-            redSeq.push_back(rule.lhs);
-            return;
+    // closureOf[n]: the items added to a state by an item with nonterminal
+    // n after the dot.
+    ItemSet closureOf[MAX_SYMBOLS] = {};
+    for (int r = 0; r < grammar.ruleCount; ++r) {
+        closureOf[grammar.rules[r].lhs].add(itemStart[r]);
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int n = FIRST_NONTERMINAL; n < grammar.symbolCount; ++n) {
+            for (int item = 0; item < itemCount; ++item) {
+                if (closureOf[n].has(item) && after(item) >= FIRST_NONTERMINAL) {
+                    changed |= closureOf[n].merge(closureOf[after(item)]);
+                }
+            }
+        }
+    }
+    auto close = [&](const ItemSet &kernel) {
+        ItemSet closed = kernel;
+        for (int item = 0; item < itemCount; ++item) {
+            if (kernel.has(item) && after(item) >= FIRST_NONTERMINAL) {
+                closed.merge(closureOf[after(item)]);
+            }
         }
-        for (int i = 0; i < rule.rhs.size(); ++i) {
-            redSeq.pop_back();
+        return closed;
+    };
+
+    // nullable, FIRST and FOLLOW; the sets are bitmasks of terminals.
+    bool nullable[MAX_SYMBOLS] = {};
+    uint64_t first[MAX_SYMBOLS] = {};
+    uint64_t follow[MAX_SYMBOLS] = {};
+    for (int t = 0; t < FIRST_NONTERMINAL; ++t) {
+        first[t] = uint64_t(1) << t;
+    }
+    follow[grammar.rules[0].lhs] = uint64_t(1) << SYMBOL_ACCEPT;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int r = 0; r < grammar.ruleCount; ++r) {
+            const GrammarRule &rule = grammar.rules[r];
+            bool prefixNullable = true;
+            for (int i = 0; i < rule.length && prefixNullable; ++i) {
+                changed |= (first[rule.rhs[i]] & ~first[rule.lhs]) != 0;
+                first[rule.lhs] |= first[rule.rhs[i]];
+                prefixNullable = nullable[rule.rhs[i]];
+            }
+            if (prefixNullable && !nullable[rule.lhs]) {
+                nullable[rule.lhs] = changed = true;
+            }
+            uint64_t trailer = follow[rule.lhs];
+            for (int i = rule.length - 1; i >= 0; --i) {
+                int symbol = rule.rhs[i];
+                changed |= (trailer & ~follow[symbol]) != 0;
+                follow[symbol] |= trailer;
+                trailer = nullable[symbol] ? trailer | first[symbol] : first[symbol];
+            }
         }
-        redSeq.push_back(rule.lhs);
     }
-    void readLine(string line) {
-        istringstream iss(line);
-        string lhs;
-        iss >> lhs;
-        vector<string> rhs;
-        string s;
-        while (iss >> s) {
-            rhs.push_back(s);
+
+    SLRTables tables;
+    ItemSet states[MAX_LR_STATES] = {};
+    ItemSet start;
+    start.add(0);
+    states[0] = close(start);
+    tables.stateCount = 1;
+    for (int state = 0; state < tables.stateCount; ++state) {
+        Action *row = tables.actions + state * COLUMNS;
+        // The kernel reached on each symbol.
+        ItemSet kernels[MAX_SYMBOLS] = {};
+        for (int item = 0; item < itemCount; ++item) {
+            if (states[state].has(item) && after(item) >= 0) {
+                kernels[after(item)].add(item + 1);
+            }
+        }
+        for (int symbol = 0; symbol < grammar.symbolCount; ++symbol) {
+            if (kernels[symbol].empty()) {
+                continue;
+            }
+            ItemSet target = close(kernels[symbol]);
+            int to = 0;
+            while (to < tables.stateCount && !(states[to] == target)) {
+                ++to;
+            }
+            if (to == tables.stateCount) {
+                if (to == MAX_LR_STATES) {
+                    throw "too many states";
+                }
+                states[tables.stateCount++] = target;
+            }
+            row[symbol] = to + 1;
+        }
+        for (int item = 0; item < itemCount; ++item) {
+            if (!states[state].has(item) || after(item) >= 0) {
+                continue;
+            }
+            int r = itemRule[item];
+            for (int t = 0; t < FIRST_NONTERMINAL; ++t) {
+                if (follow[grammar.rules[r].lhs] >> t & 1) {
+                    tables.conflicts += row[t] != 0;
+                    row[t] = -(r + 1);
+                }
+            }
         }
-        rules.push_back({lhs, rhs});
     }
-    Rule &getRuleById(int id) { return rules[id]; }
-};
+    return tables;
+}
+
+constexpr SLRTables WLP4_SLR = buildSLR(WLP4_CFG);
+static_assert(WLP4_SLR.conflicts == 0, "the WLP4 grammar is not SLR(1)");
+
+// Only the rows of the states that exist are kept in the binary.
+constexpr array<Action, WLP4_SLR.stateCount * COLUMNS> ACTIONS = [] {
+    array<Action, WLP4_SLR.stateCount * COLUMNS> actions = {};
+    for (size_t i = 0; i < actions.size(); ++i) {
+        actions[i] = WLP4_SLR.actions[i];
+    }
+    return actions;
+}();
 
 struct symbol {
-    string name;
-    string token;
-    string lexeme;
+    int id;
+    string_view lexeme;
     bool isTerminal = false;
 
 public:
-    symbol(string name) : name(name) {}
-    symbol(string token, string lexeme) : name(token), token(token), lexeme(lexeme), isTerminal(true) {}
+    symbol(int id) : id(id) {}
+    symbol(int id, string_view lexeme) : id(id), lexeme(lexeme), isTerminal(true) {}
+};
+
+// Where the parser's tokens come from. The parser pulls them one at a time,
+// so a source never has to hold more than the current token.
+class TokenSource {
+public:
+    virtual ~TokenSource() = default;
+    // false once the input ends or turns out to be bad; error() then
+    // describes the problem, or is empty at a clean end.
+    virtual bool next(symbol &token) = 0;
+    virtual string error() const = 0;
+};
+
+// Reads another source to its end up front, then replays its tokens and
+// finally its error.
+class BufferedTokenSource : public TokenSource {
+    vector<symbol> tokens;
+    size_t position = 0;
+    string sourceError;
+
+public:
+    explicit BufferedTokenSource(TokenSource &source) {
+        symbol token{0};
+        while (source.next(token)) {
+            tokens.push_back(token);
+        }
+        sourceError = source.error();
+    }
+    const vector<symbol> &all() const { return tokens; }
+    bool complete() const { return sourceError.empty(); }
+    bool next(symbol &token) override {
+        if (position == tokens.size()) {
+            return false;
+        }
+        token = tokens[position++];
+        return true;
+    }
+    string error() const override { return position == tokens.size() ? sourceError : ""; }
 };
 
+// The rules that parseParallel stitches procedures together with, and the
+// goals it parses them as.
+constexpr int START_RULE = static_cast<int>(Production::START);
+constexpr int PROCEDURES_MORE = static_cast<int>(Production::PROCEDURES_MORE);
+constexpr int PROCEDURES_MAIN = static_cast<int>(Production::PROCEDURES_MAIN);
+constexpr int PROCEDURE = productionRule(Production::PROCEDURE).lhs;
+constexpr int MAIN = productionRule(Production::MAIN).lhs;
+
 class SLR {
-    CFG cfg;
-    map<int, map<string, int>> transitions = {};
-    map<int, map<string, int>> reductions = {};
     vector<int> stateStack = {};
-    vector<symbol> inputSeq = {};
     vector<symbol> redSeq = {};
-    vector<unique_ptr<Node>> treeStack = {};
-    Tree tree;
+    bool inputEnded = false;
+    Arena arena;
+    vector<Node *> treeStack = {};
+    // parseParallel's per-thread parsers, which own the procedures' nodes.
+    vector<unique_ptr<SLR>> workers;
+    bool compact;
 
 public:
-    SLR() : stateStack(1, 0) {}
-    void setInputSeq(vector<symbol> &inputSeq) { this->inputSeq = inputSeq; }
-    void shift() {
-        redSeq.emplace_back(inputSeq.back());
-        string token = inputSeq.back().token;
-        string lexme = inputSeq.back().lexeme;
-        unique_ptr<Node> leaf = make_unique<Node>(token, lexme);
-        treeStack.emplace_back(move(leaf));
-        inputSeq.pop_back();
+    explicit SLR(bool compact = false) : stateStack(1, 0), compact(compact) {}
+    // Names that are not terminals get the last column, which is all errors.
+    static int terminalId(string_view name) {
+        int id = WLP4_CFG.find(name);
+        return id < 0 || id >= SYMBOL_ACCEPT ? WLP4_CFG.symbolCount : id;
     }
-    // returns size of the rule rhs
-    int reduce(int id) {
-        Rule &rule = cfg.getRuleById(id);
-        if (rule.nullable()) {
-            treeStack.emplace_back(move(make_unique<Node>(rule)));
-            redSeq.emplace_back(rule.lhs);
-            return 0;
+    static Action actionAt(int state, int symbol) {
+        return ACTIONS[state * COLUMNS + symbol];
+    }
+    enum class Input {
+        SYMBOL,
+        END,
+        ERROR,
+    };
+    // The input is BOF, the source's tokens, then EOF.
+    Input nextSymbol(TokenSource &source, symbol &next) {
+        if (inputEnded) {
+            return Input::END;
         }
-        unique_ptr<Node> newNode = make_unique<Node>(rule);
-        for (int i = treeStack.size() - rule.rhs.size();
-             i < treeStack.size(); ++i) {
-
-            newNode->addChild(move(treeStack[i]));
+        if (source.next(next)) {
+            return Input::SYMBOL;
         }
-        for (int i = 0; i < rule.rhs.size(); ++i) {
-            redSeq.pop_back();
-            treeStack.pop_back();
+        if (!source.error().empty()) {
+            return Input::ERROR;
         }
-        treeStack.emplace_back(move(newNode));
+        next = symbol{SYMBOL_EOF, internLexeme("EOF")};
+        inputEnded = true;
+        return Input::SYMBOL;
+    }
+    void shift(const symbol &next) {
+        redSeq.emplace_back(next);
+        treeStack.emplace_back(makeLeaf(next.id, next.lexeme));
+    }
+    // nullptr for a leaf that a compact tree leaves out.
+    Node *makeLeaf(int id, string_view lexeme) {
+        if (compact && !fixedLexeme(id).empty() && lexeme == fixedLexeme(id)) {
+            return nullptr;
+        }
+        return arena.make<Node>(static_cast<uint8_t>(id), lexeme);
+    }
+    // The node for a reduction by rule `id`: `children` has one entry per
+    // rhs symbol, nullptr where a leaf was left out.
+    Node *build(int id, Node *const *children, int n) {
+        int kept = n - static_cast<int>(count(children, children + n, nullptr));
+        Node *only = kept == 1 && n == 1 ? children[0] : nullptr;
+        if (compact && only != nullptr && only->unitCount < MAX_UNITS &&
+            (only->type == NodeType::Rule || fixedLexeme(only->leafCode).empty())) {
+            only->units[only->unitCount++] = static_cast<uint8_t>(id);
+            return only;
+        }
+        Node **array = arena.makeArray<Node *>(kept);
+        copy_if(children, children + n, array, [](Node *child) { return child != nullptr; });
+        return arena.make<Node>(id, array, kept);
+    }
+    Node *makeInner(int ruleId, initializer_list<Node *> children) {
+        return build(ruleId, children.begin(), static_cast<int>(children.size()));
+    }
+    // returns size of the rule rhs
+    int reduce(int id) {
+        const GrammarRule &rule = WLP4_CFG.rules[id];
+        int n = rule.length;
+        Node *node = build(id, treeStack.data() + treeStack.size() - n, n);
+        treeStack.erase(treeStack.end() - n, treeStack.end());
+        redSeq.erase(redSeq.end() - n, redSeq.end());
+        treeStack.emplace_back(node);
         redSeq.emplace_back(rule.lhs);
-        return rule.rhs.size();
+        return n;
     }
-
-    bool done() {
-        return (inputSeq.size() == 0);
+    // Reduces by a rule and takes the goto on its lhs.
+    void reduceAndGoto(int id) {
+        int n = reduce(id);
+        stateStack.resize(stateStack.size() - n);
+        stateStack.emplace_back(actionAt(stateStack.back(), redSeq.back().id) - 1);
     }
-    void parse() {
-        tree.root = make_unique<Node>(cfg.getRuleById(0));
-        int symCount = 0;
-        vector<unique_ptr<Node>> nodes; // temporary storage for nodes
-        while (!done()) {
-            int state = stateStack.back();
-            while (reductions.count(state) &&
-                   reductions[state].count(inputSeq.back().name)) {
-                int n = reduce(reductions[state][inputSeq.back().name]);
-                for (int i = 0; i < n; ++i) {
-                    stateStack.pop_back();
-                }
 
-                state = stateStack.back();
-                stateStack.emplace_back(transitions[state][redSeq.back().name]);
-                state = stateStack.back();
+    // Returns the root of the parse tree, or nullptr after reporting an
+    // error. The tree lives as long as the parser.
+    Node *parse(TokenSource &source) {
+        int symCount = 0;
+        symbol next{SYMBOL_BOF, internLexeme("BOF")};
+        while (true) {
+            Action action;
+            while ((action = actionAt(stateStack.back(), next.id)) < 0) {
+                reduceAndGoto(-action - 1);
             }
 
-            shift();
+            shift(next);
 
-            if (transitions.count(state) && transitions[state].count(redSeq.back().name)) {
-                stateStack.emplace_back(transitions[state][redSeq.back().name]);
+            if (action > 0) {
+                stateStack.emplace_back(action - 1);
             } else {
                 // reject
                 cerr << "ERROR at " << symCount + 1 << endl;
-                return;
+                return nullptr;
             }
-            if (
-                (redSeq.back().name != "BOF" && redSeq.back().name != "EOF"))
+            if (redSeq.back().id != SYMBOL_BOF && redSeq.back().id != SYMBOL_EOF)
                 ++symCount;
+            Input input = nextSymbol(source, next);
+            if (input == Input::END) {
+                break;
+            }
+            if (input == Input::ERROR) {
+                cerr << "ERROR: " << source.error() << endl;
+                return nullptr;
+            }
         }
         // accept
-        reduce(reductions[stateStack.back()][".ACCEPT"]);
-        treeStack[0]->print();
-    }
-    void printSeq() {
-        for (size_t i = 0; i < redSeq.size(); ++i) {
-            cout << redSeq[i].name << " ";
-        }
-        cout << ". ";
-        for (int i = inputSeq.size() - 1; i >= 0; --i) {
-            cout << inputSeq[i].name << " ";
-        }
-        cout << endl;
-    }
-    void getTransLine(istream &in) {
-        int fromState = 0;
-        int toState = 0;
-        string symbol = "";
-        string read = "";
-        getline(in, read);
-        istringstream iss(read);
-        iss >> fromState >> symbol >> toState;
-        if (!transitions.count(fromState)) {
-            transitions[fromState] = {};
-        }
-        transitions[fromState][symbol] = toState;
-    }
-    void getRedLIne(istream &in) {
-        int state;
-        int ruleId;
-        string symbol;
-        string read;
-        getline(in, read);
-        istringstream iss(read);
-        iss >> state >> ruleId >> symbol;
-        reductions[state][symbol] = ruleId;
-    }
-    void readCfgLine(string line) { cfg.readLine(line); }
+        reduce(-actionAt(stateStack.back(), SYMBOL_ACCEPT) - 1);
+        return treeStack[0];
+    }
+
+    // Parses [first, last) as exactly one `goal`, procedure or main, from
+    // the state the full parse is in after BOF. `follow` is the token after
+    // the range, which decides the final reductions as it would in parse().
+    // Returns nullptr, without reporting, if the range is anything else.
+    Node *parseGoal(const symbol *first, const symbol *last, const symbol &follow, int goal) {
+        stateStack.assign({0, actionAt(0, SYMBOL_BOF) - 1});
+        redSeq.clear();
+        treeStack.clear();
+        for (const symbol *p = first;; ++p) {
+            const symbol &next = p == last ? follow : *p;
+            Action action;
+            while ((action = actionAt(stateStack.back(), next.id)) < 0) {
+                if (redSeq.size() == 1 && redSeq[0].id == goal) {
+                    break;
+                }
+                // Reductions that would pop the state after BOF belong to
+                // the procedures spine, not to the goal.
+                if (WLP4_CFG.rules[-action - 1].length > static_cast<int>(stateStack.size()) - 2) {
+                    return nullptr;
+                }
+                reduceAndGoto(-action - 1);
+            }
+            if (p == last) {
+                break;
+            }
+            if (action <= 0) {
+                return nullptr;
+            }
+            shift(next);
+            stateStack.emplace_back(action - 1);
+        }
+        return redSeq.size() == 1 && redSeq[0].id == goal ? treeStack[0] : nullptr;
+    }
+
+    // Reads the whole input, cuts it where each top-level procedure starts
+    // (INT ID LPAREN, or INT WAIN LPAREN for main) and parses the pieces as
+    // procedure and main subgoals on up to `jobs` threads, stitching them
+    // into the procedures spine in order. Input that is not procedures then
+    // main, or a piece that does not parse, goes through parse() instead,
+    // so the tree and any error are always those of the sequential parse.
+    Node *parseParallel(TokenSource &source, unsigned jobs) {
+        BufferedTokenSource buffered(source);
+        const vector<symbol> &tokens = buffered.all();
+        vector<size_t> starts;
+        for (size_t i = 0; i + 2 < tokens.size(); ++i) {
+            int name = tokens[i + 1].id;
+            if (tokens[i].id == static_cast<int>(TokenKind::INT) &&
+                (name == static_cast<int>(TokenKind::ID) || name == static_cast<int>(TokenKind::WAIN)) &&
+                tokens[i + 2].id == static_cast<int>(TokenKind::LPAREN)) {
+                starts.push_back(i);
+            }
+        }
+        if (!buffered.complete() || starts.empty() || starts[0] != 0 ||
+            tokens[starts.back() + 1].id != static_cast<int>(TokenKind::WAIN)) {
+            return parse(buffered);
+        }
+        size_t count = starts.size();
+        starts.push_back(tokens.size());
+        symbol end{SYMBOL_EOF, internLexeme("EOF")};
+        vector<Node *> goals(count);
+        size_t workerCount = min<size_t>(jobs, count);
+        vector<thread> threads;
+        for (size_t w = 0; w < workerCount; ++w) {
+            workers.push_back(make_unique<SLR>(compact));
+            threads.emplace_back([&, worker = workers.back().get(), w] {
+                for (size_t k = w * count / workerCount; k < (w + 1) * count / workerCount; ++k) {
+                    const symbol &follow = k + 1 < count ? tokens[starts[k + 1]] : end;
+                    goals[k] = worker->parseGoal(&tokens[starts[k]], &tokens[starts[k + 1]], follow,
+                                      k + 1 < count ? PROCEDURE : MAIN);
+                }
+            });
+        }
+        for (thread &t : threads) {
+            t.join();
+        }
+        if (find(goals.begin(), goals.end(), nullptr) != goals.end()) {
+            return parse(buffered);
+        }
+        Node *spine = makeInner(PROCEDURES_MAIN, {goals[count - 1]});
+        for (size_t k = count - 1; k-- > 0;) {
+            spine = makeInner(PROCEDURES_MORE, {goals[k], spine});
+        }
+        return makeInner(START_RULE, {makeLeaf(SYMBOL_BOF, internLexeme("BOF")), spine,
+                                       makeLeaf(SYMBOL_EOF, internLexeme("EOF"))});
+    }
+};
+
+// "KIND lexeme" lines, as written by wlp4scan.
+class TextTokenSource : public TokenSource {
+    istream &in;
+    string line;
+
+public:
+    explicit TextTokenSource(istream &in) : in(in) {}
+    bool next(symbol &token) override {
+        if (!getline(in, line)) {
+            return false;
+        }
+        istringstream iss{line};
+        string kind, lexeme;
+        iss >> kind >> lexeme;
+        token = symbol{SLR::terminalId(kind), internLexeme(lexeme)};
+        return true;
+    }
+    string error() const override { return ""; }
+};
+
+// The binary token stream written by wlp4scan --binary.
+class BinaryTokenSource : public TokenSource {
+    TokenStreamReader reader;
+
+public:
+    explicit BinaryTokenSource(istream &in) : reader(in) {}
+    bool next(symbol &token) override {
+        TokenKind kind;
+        string_view lexeme;
+        if (!reader.next(kind, lexeme)) {
+            return false;
+        }
+        token = symbol{static_cast<int>(kind), internLexeme(lexeme)};
+        return true;
+    }
+    string error() const override { return reader.ok() ? "" : "malformed token stream"; }
 };
 
-int main() {
-    SLR slr;
-    string read;
-    istringstream wlpin{WLP4_COMBINED};
-    getline(wlpin, read); // Skip the first line
-    vector<symbol> inputSeq;
-    while (getline(wlpin, read) && read[0] != '.') // CFG
-    {
-        slr.readCfgLine(read);
+// WLP4 source, scanned in-process as the parser asks for tokens.
+class ScannerTokenSource : public TokenSource {
+    DFA dfa;
+    Source source;
+    const char *p;
+    const char *end;
+    string scanError;
+
+public:
+    explicit ScannerTokenSource(int fd)
+        : source(fd), p(source.view().data()), end(source.view().data() + source.view().size()) {}
+    bool next(symbol &token) override {
+        if (!source.ok()) {
+            scanError = "cannot read standard input";
+            return false;
+        }
+        Token scanned;
+        if (dfa.next(p, end, scanned, scanError) != ScanStatus::TOKEN) {
+            return false;
+        }
+        token = symbol{static_cast<int>(scanned.kind), internLexeme(scanned.lexeme)};
+        return true;
     }
-    // while (cin >> read && read[0] != '.') // INPUT
-    // {
-    //     inputSeq.emplace_back(read);
-    // }
+    string error() const override { return scanError; }
+};
 
-    // // reverse the vec so the back is the leftmost
-    // reverse(inputSeq.begin(), inputSeq.end());
-    // slr.setInputSeq(inputSeq);
+// Counts the tokens another source hands out, for --bench.
+class CountingTokenSource : public TokenSource {
+    TokenSource &source;
 
-    // TRANSITIONS
-    while (getline(wlpin, read) && read[0] != '.') {
-        istringstream iss{read};
-        slr.getTransLine(iss);
+public:
+    size_t count = 0;
+    explicit CountingTokenSource(TokenSource &source) : source(source) {}
+    bool next(symbol &token) override {
+        if (!source.next(token)) {
+            return false;
+        }
+        ++count;
+        return true;
+    }
+    string error() const override { return source.error(); }
+};
+
+// usage: wlp4parse [--binary] [--scan] [--jobs N] [--compact] [--bench]
+// Tokens are read from stdin as "KIND lexeme" lines, or as WLP4 source that
+// is scanned in-process with --scan. --binary switches both the token input
+// and the tree output to the binary formats in common/. --jobs N parses the
+// procedures on N threads (0 picks one per hardware thread), and --compact
+// keeps the tree compact in memory; the output is the same either way.
+// --bench reads and parses as usual but writes no tree, and reports the
+// token count, time and tokens/s on stderr.
+int main(int argc, char *argv[]) {
+    auto started = chrono::steady_clock::now();
+    ios::sync_with_stdio(false);
+    bool binary = false;
+    bool scan = false;
+    bool compact = false;
+    bool bench = false;
+    unsigned jobs = 1;
+    for (int i = 1; i < argc; ++i) {
+        string_view arg(argv[i]);
+        if (arg == "--jobs" && !parseJobs(i + 1 < argc ? argv[++i] : nullptr, jobs)) {
+            cerr << "ERROR: invalid --jobs value" << endl;
+            return 1;
+        }
+        binary |= arg == "--binary";
+        scan |= arg == "--scan";
+        compact |= arg == "--compact";
+        bench |= arg == "--bench";
     }
-    // REDUCTIONS
-    while (getline(wlpin, read) && read[0] != '.') {
-        istringstream iss{read};
-        slr.getRedLIne(iss);
+    if (jobs == 0) {
+        jobs = max(1u, thread::hardware_concurrency());
     }
+    SLR slr(compact);
 
     // WLP4 from stdin
-    inputSeq.emplace_back(symbol{"BOF", "BOF"});
-    while (getline(cin, read)) {
-        istringstream iss{read};
-        string token, lexeme;
-        iss >> token >> lexeme;
-        inputSeq.emplace_back(symbol{token, lexeme});
-    }
-    inputSeq.emplace_back(symbol{"EOF", "EOF"});
-    reverse(inputSeq.begin(), inputSeq.end());
-    slr.setInputSeq(inputSeq);
-    slr.parse();
+    unique_ptr<TokenSource> source;
+    if (scan) {
+        source = make_unique<ScannerTokenSource>(STDIN_FILENO);
+    } else if (binary) {
+        source = make_unique<BinaryTokenSource>(cin);
+    } else {
+        source = make_unique<TextTokenSource>(cin);
+    }
+    CountingTokenSource counted(*source);
+    Node *root = jobs > 1 ? slr.parseParallel(counted, jobs) : slr.parse(counted);
+    if (bench) {
+        chrono::duration<double> seconds = chrono::steady_clock::now() - started;
+        cerr << counted.count << " tokens in " << seconds.count() << " s, "
+             << static_cast<size_t>(counted.count / seconds.count()) << " tokens/s" << endl;
+        return 0;
+    }
+    if (root == nullptr) {
+        return 0;
+    }
+    if (binary) {
+        TreeWriter writer(cout, productionTreeRules());
+        root->write(writer);
+    } else {
+        root->print();
+    }
 }
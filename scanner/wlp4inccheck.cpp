@@ -0,0 +1,109 @@
+#include "wlp4scanner.h"
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fragments the random texts and edits are built from. They include
+// keywords and their prefixes, comment starts, an invalid character and an
+// out-of-range number, so edits often join, split or break tokens.
+constexpr std::string_view PIECES[] = {
+    "int", "wain", "return", "if", "x", "abc", "1", "23", "0", "==", "=", "<", "<=", "!", "!=",
+    "/", "//", " ", "\n", " //c ", "$", "99999999999", "(", ")", "+", "retur", "n", "e",
+};
+
+std::string randomText(std::mt19937 &rng, unsigned maxPieces) {
+  std::string text;
+  for (unsigned n = rng() % maxPieces; n > 0; --n) {
+    text += PIECES[rng() % std::size(PIECES)];
+  }
+  return text;
+}
+
+bool sameTokens(const std::vector<LexedToken> &a, const std::vector<LexedToken> &b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i].kind != b[i].kind || a[i].offset != b[i].offset || a[i].length != b[i].length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The edit kept every token outside the range it reported, kind and length
+// included: the ones before it as they were, the ones after it shifted by
+// the edit's length change.
+bool rangeHolds(const std::vector<LexedToken> &before, const std::vector<LexedToken> &after, TokenRange range,
+                std::ptrdiff_t delta) {
+  if (before.size() - range.removed + range.inserted != after.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < range.first; ++i) {
+    if (before[i].offset != after[i].offset || before[i].kind != after[i].kind ||
+        before[i].length != after[i].length) {
+      return false;
+    }
+  }
+  for (std::size_t i = range.first + range.removed; i < before.size(); ++i) {
+    const LexedToken &moved = after[i - range.removed + range.inserted];
+    if (static_cast<std::ptrdiff_t>(before[i].offset) + delta != static_cast<std::ptrdiff_t>(moved.offset) ||
+        before[i].kind != moved.kind || before[i].length != moved.length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// usage: wlp4inccheck [--seed N] [--texts N] [--edits N]
+// Applies random edits to random texts with IncrementalScanner and checks
+// after every edit that its tokens and error match a full scan of the
+// edited text, and that the reported range covers every changed token.
+// Prints the first failing case and exits 1, or "ok" and exits 0.
+int main(int argc, char *argv[]) {
+  unsigned seed = 5;
+  unsigned texts = 2000;
+  unsigned edits = 30;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string_view arg(argv[i]);
+    unsigned value = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+    if (arg == "--seed") {
+      seed = value;
+    } else if (arg == "--texts") {
+      texts = value;
+    } else if (arg == "--edits") {
+      edits = value;
+    }
+  }
+  DFA dfa;
+  std::mt19937 rng(seed);
+  std::size_t relexed = 0;
+  for (unsigned t = 0; t < texts; ++t) {
+    IncrementalScanner incremental(dfa, randomText(rng, 80));
+    for (unsigned e = 0; e < edits; ++e) {
+      std::size_t size = incremental.text().size();
+      std::size_t offset = rng() % (size + 1);
+      std::size_t removed = std::min<std::size_t>(size - offset, rng() % 6);
+      std::string inserted = randomText(rng, 4);
+      std::string before = incremental.text();
+      std::vector<LexedToken> oldTokens = incremental.tokens();
+      TokenRange range = incremental.edit(offset, removed, inserted);
+      relexed += range.inserted;
+      IncrementalScanner full(dfa, incremental.text());
+      std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(inserted.size()) - static_cast<std::ptrdiff_t>(removed);
+      if (!sameTokens(full.tokens(), incremental.tokens()) || full.error() != incremental.error() ||
+          !rangeHolds(oldTokens, incremental.tokens(), range, delta)) {
+        std::cout << "mismatch in text " << t << ", edit " << e << ": replaced " << removed << " bytes at "
+                  << offset << " with \"" << inserted << "\"\n--- before\n"
+                  << before << "\n--- after\n"
+                  << incremental.text() << "\n";
+        return 1;
+      }
+    }
+  }
+  std::cout << "ok: " << texts * edits << " edits, " << relexed << " tokens re-lexed\n";
+}
@@ -0,0 +1,76 @@
+#include "wlp4scanner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+
+// Scans `source` `repeat` times with the current run kernels, tokens
+// discarded, and returns MB/s.
+double scanRate(const DFA &dfa, std::string_view source, int repeat, std::size_t &tokens) {
+  std::string error;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat; ++i) {
+    tokens = 0;
+    if (!dfa.scan(source, [&tokens](const Token &) { ++tokens; }, error)) {
+      std::cerr << "ERROR: " << error << "\n";
+      std::exit(1);
+    }
+  }
+  std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+  return source.size() * static_cast<double>(repeat) / seconds.count() / 1e6;
+}
+
+// usage: wlp4scanbench [--repeat N] file...
+// Times DFA::scan over each file with the scalar run kernels and with each
+// SIMD set the CPU supports, and prints one MB/s figure per set. Output is
+// discarded, so this measures the scanner alone. bench/wlp4programs.py
+// generates suitable inputs.
+int main(int argc, char *argv[]) {
+  int repeat = 5;
+  DFA dfa;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg(argv[i]);
+    if (arg == "--repeat" && i + 1 < argc) {
+      repeat = std::max(1, std::atoi(argv[++i]));
+      continue;
+    }
+    int fd = open(argv[i], O_RDONLY);
+    if (fd < 0) {
+      std::cerr << "ERROR: cannot open " << argv[i] << "\n";
+      return 1;
+    }
+    Source source(fd);
+    close(fd);
+    if (!source.ok()) {
+      std::cerr << "ERROR: cannot read " << argv[i] << "\n";
+      return 1;
+    }
+    struct {
+      const char *name;
+      RunKernels kernels;
+      bool supported;
+    } sets[] = {
+        {"scalar", SCALAR_RUN_KERNELS, true},
+#if defined(__x86_64__) || defined(__i386__)
+        {"sse2", SSE2_RUN_KERNELS, static_cast<bool>(__builtin_cpu_supports("sse2"))},
+        {"avx2", AVX2_RUN_KERNELS, static_cast<bool>(__builtin_cpu_supports("avx2"))},
+#endif
+    };
+    std::size_t tokens = 0;
+    std::cout << argv[i] << ": " << source.view().size() << " bytes";
+    for (const auto &set : sets) {
+      if (!set.supported) {
+        continue;
+      }
+      runKernels = set.kernels;
+      double rate = scanRate(dfa, source.view(), repeat, tokens);
+      std::cout << ", " << set.name << " " << static_cast<int>(rate) << " MB/s";
+    }
+    std::cout << ", " << tokens << " tokens\n";
+    runKernels = selectRunKernels();
+  }
+}
@@ -0,0 +1,1061 @@
+// The WLP4 scanner core: the token DFA compiled at build time and the DFA
+// class that runs it over a buffer, usable in-process as well as from the
+// wlp4scan command.
+#ifndef WLP4_SCANNER_H
+#define WLP4_SCANNER_H
+
+#include "../common/wlp4perfecthash.h"
+#include "../common/wlp4source.h"
+#include "../common/wlp4token.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+inline constexpr unsigned char wlp4_dfa[] = {
+  0x2e, 0x41, 0x4c, 0x50, 0x48, 0x41, 0x42, 0x45, 0x54, 0x0a, 0x30, 0x2d,
+  0x39, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x28, 0x20,
+  0x29, 0x20, 0x7b, 0x20, 0x7d, 0x20, 0x3d, 0x20, 0x21, 0x20, 0x3c, 0x20,
+  0x3e, 0x20, 0x2b, 0x20, 0x2d, 0x20, 0x2a, 0x20, 0x2f, 0x20, 0x25, 0x20,
+  0x2c, 0x20, 0x3b, 0x20, 0x5b, 0x20, 0x5d, 0x20, 0x26, 0x0a, 0x2e, 0x53,
+  0x54, 0x41, 0x54, 0x45, 0x53, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x49, 0x44, 0x21, 0x20, 0x5a, 0x45, 0x52, 0x4f, 0x21, 0x20, 0x4e, 0x55,
+  0x4d, 0x21, 0x20, 0x4c, 0x50, 0x41, 0x52, 0x45, 0x4e, 0x21, 0x20, 0x52,
+  0x50, 0x41, 0x52, 0x45, 0x4e, 0x21, 0x20, 0x4c, 0x42, 0x52, 0x41, 0x43,
+  0x45, 0x21, 0x20, 0x52, 0x42, 0x52, 0x41, 0x43, 0x45, 0x21, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x72, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x72, 0x65, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74,
+  0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75, 0x21,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75, 0x72, 0x21,
+  0x20, 0x52, 0x45, 0x54, 0x55, 0x52, 0x4e, 0x21, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x69, 0x21, 0x20, 0x49, 0x46, 0x21, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x65, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c,
+  0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c, 0x73, 0x21, 0x20,
+  0x45, 0x4c, 0x53, 0x45, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77,
+  0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68, 0x21, 0x20, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68, 0x69, 0x21, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x77, 0x68, 0x69, 0x6c, 0x21, 0x20, 0x57, 0x48, 0x49, 0x4c,
+  0x45, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x21, 0x20, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x72, 0x69, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x69, 0x6e, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72,
+  0x69, 0x6e, 0x74, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72,
+  0x69, 0x6e, 0x74, 0x6c, 0x21, 0x20, 0x50, 0x52, 0x49, 0x4e, 0x54, 0x4c,
+  0x4e, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x21, 0x20,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x21, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x21, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x21, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x61, 0x21, 0x20, 0x50, 0x55,
+  0x54, 0x43, 0x48, 0x41, 0x52, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x67, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x21, 0x20,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x21, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x21, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x68, 0x21, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x68, 0x61, 0x21, 0x20, 0x47, 0x45,
+  0x54, 0x43, 0x48, 0x41, 0x52, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x77, 0x61, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x61, 0x69,
+  0x21, 0x20, 0x57, 0x41, 0x49, 0x4e, 0x21, 0x0a, 0x42, 0x45, 0x43, 0x4f,
+  0x4d, 0x45, 0x53, 0x21, 0x20, 0x45, 0x51, 0x21, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x69, 0x6e, 0x21, 0x20, 0x49, 0x4e, 0x54, 0x21, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x65, 0x78, 0x20, 0x4e, 0x45, 0x21, 0x0a, 0x4c,
+  0x54, 0x21, 0x20, 0x47, 0x54, 0x21, 0x20, 0x4c, 0x45, 0x21, 0x20, 0x47,
+  0x45, 0x21, 0x0a, 0x50, 0x4c, 0x55, 0x53, 0x21, 0x20, 0x4d, 0x49, 0x4e,
+  0x55, 0x53, 0x21, 0x20, 0x53, 0x54, 0x41, 0x52, 0x21, 0x20, 0x53, 0x4c,
+  0x41, 0x53, 0x48, 0x21, 0x20, 0x50, 0x43, 0x54, 0x21, 0x20, 0x43, 0x4f,
+  0x4d, 0x4d, 0x41, 0x21, 0x20, 0x53, 0x45, 0x4d, 0x49, 0x21, 0x20, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x6e, 0x65, 0x21, 0x20, 0x4e, 0x45, 0x57, 0x21, 0x0a, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x64, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64,
+  0x65, 0x21, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c, 0x21,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c, 0x65, 0x21, 0x20,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c, 0x65, 0x74, 0x21, 0x20,
+  0x44, 0x45, 0x4c, 0x45, 0x54, 0x45, 0x21, 0x0a, 0x4c, 0x42, 0x52, 0x41,
+  0x43, 0x4b, 0x21, 0x20, 0x52, 0x42, 0x52, 0x41, 0x43, 0x4b, 0x21, 0x20,
+  0x41, 0x4d, 0x50, 0x21, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x21,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x21, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x4c, 0x21, 0x20, 0x4e, 0x55, 0x4c, 0x4c,
+  0x21, 0x0a, 0x2e, 0x54, 0x52, 0x41, 0x4e, 0x53, 0x49, 0x54, 0x49, 0x4f,
+  0x4e, 0x53, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x30, 0x20, 0x5a,
+  0x45, 0x52, 0x4f, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x31, 0x2d,
+  0x39, 0x20, 0x4e, 0x55, 0x4d, 0x0a, 0x4e, 0x55, 0x4d, 0x20, 0x30, 0x2d,
+  0x39, 0x20, 0x4e, 0x55, 0x4d, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x28, 0x20, 0x4c, 0x50, 0x41, 0x52, 0x45, 0x4e, 0x0a, 0x73, 0x74, 0x61,
+  0x72, 0x74, 0x20, 0x29, 0x20, 0x52, 0x50, 0x41, 0x52, 0x45, 0x4e, 0x0a,
+  0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x7b, 0x20, 0x4c, 0x42, 0x52, 0x41,
+  0x43, 0x45, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x7d, 0x20, 0x52,
+  0x42, 0x52, 0x41, 0x43, 0x45, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x72, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x72, 0x20, 0x65, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72,
+  0x65, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x20, 0x61, 0x2d, 0x64,
+  0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x20,
+  0x74, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75,
+  0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x20, 0x75,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x20, 0x61, 0x2d, 0x74, 0x20,
+  0x76, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20,
+  0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75,
+  0x20, 0x72, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75,
+  0x72, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75, 0x20,
+  0x61, 0x2d, 0x71, 0x20, 0x73, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x72, 0x65, 0x74, 0x75, 0x72, 0x20, 0x6e, 0x20, 0x52, 0x45, 0x54, 0x55,
+  0x52, 0x4e, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x72, 0x65, 0x74, 0x75,
+  0x72, 0x20, 0x61, 0x2d, 0x6d, 0x20, 0x6f, 0x2d, 0x7a, 0x20, 0x41, 0x2d,
+  0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74, 0x61,
+  0x72, 0x74, 0x20, 0x69, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x69, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x69, 0x20, 0x66, 0x20, 0x49, 0x46, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x69, 0x20, 0x61, 0x2d, 0x65, 0x20, 0x67,
+  0x2d, 0x6d, 0x20, 0x6f, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x65, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x65, 0x20, 0x6c, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65,
+  0x6c, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x20, 0x61, 0x2d, 0x6b,
+  0x20, 0x6d, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c, 0x20,
+  0x73, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c, 0x73, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c, 0x20, 0x61, 0x2d, 0x72, 0x20, 0x74,
+  0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65, 0x6c, 0x73, 0x20, 0x65,
+  0x20, 0x45, 0x4c, 0x53, 0x45, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65,
+  0x6c, 0x73, 0x20, 0x61, 0x2d, 0x64, 0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41,
+  0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74,
+  0x61, 0x72, 0x74, 0x20, 0x77, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77,
+  0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x20, 0x68, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x77, 0x68, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77,
+  0x20, 0x62, 0x2d, 0x67, 0x20, 0x69, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a,
+  0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x77, 0x68, 0x20, 0x69, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77,
+  0x68, 0x69, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68, 0x20, 0x61,
+  0x2d, 0x68, 0x20, 0x6a, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77,
+  0x68, 0x69, 0x20, 0x6c, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68,
+  0x69, 0x6c, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68, 0x69, 0x20,
+  0x61, 0x2d, 0x6b, 0x20, 0x6d, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x77, 0x68, 0x69, 0x6c, 0x20, 0x65, 0x20, 0x57, 0x48, 0x49, 0x4c, 0x45,
+  0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x68, 0x69, 0x6c, 0x20, 0x61,
+  0x2d, 0x64, 0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x70, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x70, 0x20, 0x72, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x20, 0x61, 0x2d, 0x71,
+  0x20, 0x73, 0x2d, 0x74, 0x20, 0x76, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a,
+  0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x72, 0x20, 0x69, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x69, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x20, 0x61,
+  0x2d, 0x68, 0x20, 0x6a, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x69, 0x20, 0x6e, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72,
+  0x69, 0x6e, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x69, 0x20,
+  0x61, 0x2d, 0x6d, 0x20, 0x6f, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x70, 0x72, 0x69, 0x6e, 0x20, 0x74, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x70, 0x72, 0x69, 0x6e, 0x74, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x69, 0x6e, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75, 0x2d, 0x7a, 0x20,
+  0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x20, 0x6c, 0x20,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x6c, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x20, 0x61,
+  0x2d, 0x6b, 0x20, 0x6d, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70,
+  0x72, 0x69, 0x6e, 0x74, 0x6c, 0x20, 0x6e, 0x20, 0x50, 0x52, 0x49, 0x4e,
+  0x54, 0x4c, 0x4e, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x72, 0x69,
+  0x6e, 0x74, 0x6c, 0x20, 0x61, 0x2d, 0x6d, 0x20, 0x6f, 0x2d, 0x7a, 0x20,
+  0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x70, 0x20, 0x75, 0x20, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x75, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x20,
+  0x74, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75,
+  0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x20, 0x63,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x20, 0x61, 0x20, 0x62, 0x20,
+  0x64, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20,
+  0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63,
+  0x20, 0x68, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63,
+  0x68, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x20,
+  0x61, 0x2d, 0x67, 0x20, 0x69, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x70, 0x75, 0x74, 0x63, 0x68, 0x20, 0x61, 0x20, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x61, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x20, 0x62, 0x2d, 0x7a, 0x20, 0x41,
+  0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x61, 0x20, 0x72, 0x20,
+  0x50, 0x55, 0x54, 0x43, 0x48, 0x41, 0x52, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x70, 0x75, 0x74, 0x63, 0x68, 0x61, 0x20, 0x61, 0x2d, 0x71, 0x20,
+  0x73, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20,
+  0x49, 0x44, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x67, 0x20, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x67, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67,
+  0x20, 0x65, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x67, 0x20, 0x61, 0x2d, 0x64, 0x20, 0x66, 0x2d,
+  0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44,
+  0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x20, 0x74, 0x20, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x67, 0x65, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75, 0x2d, 0x7a, 0x20,
+  0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x20, 0x63, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x0a, 0x73, 0x65, 0x65, 0x6e,
+  0x5f, 0x67, 0x65, 0x74, 0x20, 0x61, 0x20, 0x62, 0x20, 0x64, 0x2d, 0x7a,
+  0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x20, 0x68, 0x20,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x68, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74, 0x63, 0x20, 0x61, 0x2d, 0x67,
+  0x20, 0x69, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65, 0x74,
+  0x63, 0x68, 0x20, 0x61, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65,
+  0x74, 0x63, 0x68, 0x61, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65,
+  0x74, 0x63, 0x68, 0x20, 0x62, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x67, 0x65, 0x74, 0x63, 0x68, 0x61, 0x20, 0x72, 0x20, 0x47, 0x45, 0x54,
+  0x43, 0x48, 0x41, 0x52, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x67, 0x65,
+  0x74, 0x63, 0x68, 0x61, 0x20, 0x61, 0x2d, 0x71, 0x20, 0x73, 0x2d, 0x7a,
+  0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x20, 0x61, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x77, 0x61, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x61,
+  0x20, 0x69, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x61, 0x69, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x61, 0x20, 0x61, 0x2d, 0x68, 0x20,
+  0x6a, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20,
+  0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x77, 0x61, 0x69, 0x20,
+  0x6e, 0x20, 0x57, 0x41, 0x49, 0x4e, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x77, 0x61, 0x69, 0x20, 0x61, 0x2d, 0x6d, 0x20, 0x6f, 0x2d, 0x7a, 0x20,
+  0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73,
+  0x74, 0x61, 0x72, 0x74, 0x20, 0x3d, 0x20, 0x42, 0x45, 0x43, 0x4f, 0x4d,
+  0x45, 0x53, 0x0a, 0x42, 0x45, 0x43, 0x4f, 0x4d, 0x45, 0x53, 0x20, 0x3d,
+  0x20, 0x45, 0x51, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x69, 0x20, 0x6e,
+  0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x69, 0x6e, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x69, 0x6e, 0x20, 0x74, 0x20, 0x49, 0x4e, 0x54, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x69, 0x6e, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75,
+  0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x21, 0x20, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x65, 0x78, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x65,
+  0x78, 0x20, 0x3d, 0x20, 0x4e, 0x45, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74,
+  0x20, 0x3c, 0x20, 0x4c, 0x54, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x3e, 0x20, 0x47, 0x54, 0x0a, 0x4c, 0x54, 0x20, 0x3d, 0x20, 0x4c, 0x45,
+  0x0a, 0x47, 0x54, 0x20, 0x3d, 0x20, 0x47, 0x45, 0x0a, 0x73, 0x74, 0x61,
+  0x72, 0x74, 0x20, 0x2b, 0x20, 0x50, 0x4c, 0x55, 0x53, 0x0a, 0x73, 0x74,
+  0x61, 0x72, 0x74, 0x20, 0x2d, 0x20, 0x4d, 0x49, 0x4e, 0x55, 0x53, 0x0a,
+  0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x2a, 0x20, 0x53, 0x54, 0x41, 0x52,
+  0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x2f, 0x20, 0x53, 0x4c, 0x41,
+  0x53, 0x48, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x25, 0x20, 0x50,
+  0x43, 0x54, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x2c, 0x20, 0x43,
+  0x4f, 0x4d, 0x4d, 0x41, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x3b,
+  0x20, 0x53, 0x45, 0x4d, 0x49, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x6e, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x6e, 0x20, 0x65, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e,
+  0x65, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e, 0x20, 0x61, 0x2d, 0x64,
+  0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e, 0x65, 0x20,
+  0x77, 0x20, 0x4e, 0x45, 0x57, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x6e,
+  0x65, 0x20, 0x61, 0x2d, 0x76, 0x20, 0x78, 0x2d, 0x7a, 0x20, 0x41, 0x2d,
+  0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74, 0x61,
+  0x72, 0x74, 0x20, 0x64, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x0a,
+  0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x20, 0x65, 0x20, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x64, 0x65, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x20,
+  0x61, 0x2d, 0x64, 0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f,
+  0x64, 0x65, 0x20, 0x6c, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65,
+  0x6c, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x20, 0x61, 0x2d,
+  0x6b, 0x20, 0x6d, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d,
+  0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65,
+  0x6c, 0x20, 0x65, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c,
+  0x65, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c, 0x20, 0x61,
+  0x2d, 0x64, 0x20, 0x66, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64,
+  0x65, 0x6c, 0x65, 0x20, 0x74, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64,
+  0x65, 0x6c, 0x65, 0x74, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64, 0x65,
+  0x6c, 0x65, 0x20, 0x61, 0x2d, 0x73, 0x20, 0x75, 0x2d, 0x7a, 0x20, 0x41,
+  0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x65,
+  0x65, 0x6e, 0x5f, 0x64, 0x65, 0x6c, 0x65, 0x74, 0x20, 0x65, 0x20, 0x44,
+  0x45, 0x4c, 0x45, 0x54, 0x45, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x64,
+  0x65, 0x6c, 0x65, 0x74, 0x20, 0x61, 0x2d, 0x64, 0x20, 0x66, 0x2d, 0x7a,
+  0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a,
+  0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x5b, 0x20, 0x4c, 0x42, 0x52, 0x41,
+  0x43, 0x4b, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x5d, 0x20, 0x52,
+  0x42, 0x52, 0x41, 0x43, 0x4b, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x26, 0x20, 0x41, 0x4d, 0x50, 0x0a, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20,
+  0x4e, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x0a, 0x73, 0x65, 0x65,
+  0x6e, 0x5f, 0x4e, 0x20, 0x55, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e,
+  0x55, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x20, 0x41, 0x2d, 0x54,
+  0x20, 0x56, 0x2d, 0x5a, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x20,
+  0x4c, 0x20, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x4c, 0x0a, 0x73,
+  0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x20, 0x41, 0x2d, 0x4b, 0x20, 0x4d,
+  0x2d, 0x5a, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e, 0x55, 0x4c, 0x20, 0x4c,
+  0x20, 0x4e, 0x55, 0x4c, 0x4c, 0x0a, 0x73, 0x65, 0x65, 0x6e, 0x5f, 0x4e,
+  0x55, 0x4c, 0x20, 0x41, 0x2d, 0x4b, 0x20, 0x4d, 0x2d, 0x5a, 0x20, 0x61,
+  0x2d, 0x7a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x73, 0x74,
+  0x61, 0x72, 0x74, 0x20, 0x61, 0x2d, 0x63, 0x20, 0x66, 0x20, 0x68, 0x20,
+  0x6a, 0x2d, 0x6d, 0x20, 0x6f, 0x20, 0x71, 0x20, 0x73, 0x20, 0x74, 0x20,
+  0x75, 0x20, 0x76, 0x20, 0x78, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x4d, 0x20,
+  0x4f, 0x2d, 0x5a, 0x20, 0x49, 0x44, 0x0a, 0x52, 0x45, 0x54, 0x55, 0x52,
+  0x4e, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d,
+  0x39, 0x20, 0x49, 0x44, 0x0a, 0x57, 0x41, 0x49, 0x4e, 0x20, 0x61, 0x2d,
+  0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44,
+  0x0a, 0x49, 0x4e, 0x54, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a,
+  0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x49, 0x46, 0x20, 0x61,
+  0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49,
+  0x44, 0x0a, 0x45, 0x4c, 0x53, 0x45, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41,
+  0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x57, 0x48,
+  0x49, 0x4c, 0x45, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x50, 0x52, 0x49, 0x4e, 0x54,
+  0x4c, 0x4e, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30,
+  0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x50, 0x55, 0x54, 0x43, 0x48, 0x41,
+  0x52, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d,
+  0x39, 0x20, 0x49, 0x44, 0x0a, 0x47, 0x45, 0x54, 0x43, 0x48, 0x41, 0x52,
+  0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39,
+  0x20, 0x49, 0x44, 0x0a, 0x4e, 0x55, 0x4c, 0x4c, 0x20, 0x61, 0x2d, 0x7a,
+  0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a,
+  0x4e, 0x45, 0x57, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x44, 0x45, 0x4c, 0x45, 0x54,
+  0x45, 0x20, 0x61, 0x2d, 0x7a, 0x20, 0x41, 0x2d, 0x5a, 0x20, 0x30, 0x2d,
+  0x39, 0x20, 0x49, 0x44, 0x0a, 0x49, 0x44, 0x20, 0x41, 0x2d, 0x5a, 0x20,
+  0x61, 0x2d, 0x7a, 0x20, 0x30, 0x2d, 0x39, 0x20, 0x49, 0x44, 0x0a, 0x2e,
+  0x49, 0x4e, 0x50, 0x55, 0x54, 0x0a, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e,
+  0x0a, 0x65, 0x6c, 0x73, 0x65, 0x0a, 0x69, 0x66, 0x0a, 0x77, 0x68, 0x69,
+  0x6c, 0x65, 0x0a, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x6c, 0x6e, 0x0a, 0x67,
+  0x65, 0x74, 0x63, 0x68, 0x61, 0x72, 0x0a, 0x4e, 0x55, 0x4c, 0x4c, 0x0a,
+  0x6e, 0x65, 0x77, 0x0a, 0x64, 0x65, 0x6c, 0x65, 0x74, 0x65, 0x0a, 0x3d,
+  0x3d, 0x0a, 0x26, 0x0a, 0x2a, 0x0a, 0x2f, 0x0a, 0x25, 0x0a, 0x30, 0x39,
+  0x31, 0x30, 0x32, 0x0a, 0x31, 0x32, 0x33, 0x31, 0x0a, 0x69, 0x6e, 0x74,
+  0x0a, 0x77, 0x61, 0x69, 0x6e, 0x0a, 0x69, 0x6e, 0x74, 0x77, 0x61, 0x69,
+  0x6e, 0x0a, 0x32, 0x39, 0x33, 0x61, 0x62, 0x0a, 0x31, 0x61, 0x0a, 0x6e,
+  0x61, 0x6e, 0x63, 0x79, 0x0a, 0x77, 0x61, 0x69, 0x73, 0x74, 0x0a, 0x69,
+  0x6e, 0x74, 0x65, 0x6c, 0x6c, 0x0a, 0x28, 0x0a, 0x29, 0x0a, 0x7b, 0x0a,
+  0x7d, 0x0a, 0x2b, 0x0a, 0x3d, 0x0a, 0x3d, 0x3d, 0x0a, 0x3e, 0x0a, 0x3c,
+  0x0a, 0x2d, 0x0a, 0x3e, 0x3d, 0x0a, 0x3c, 0x3d, 0x0a, 0x5b, 0x0a, 0x5d,
+  0x0a, 0x2a, 0x0a, 0x77, 0x68, 0x61, 0x6c, 0x65, 0x0a, 0x69, 0x6e, 0x63,
+  0x72, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x0a, 0x69, 0x71, 0x0a
+};
+inline constexpr unsigned int wlp4_dfa_len = 3790;
+
+inline constexpr std::string_view STATES      = ".STATES";
+inline constexpr std::string_view TRANSITIONS = ".TRANSITIONS";
+inline constexpr std::string_view INPUT       = ".INPUT";
+
+// The DFA description above is compiled into a dense transition table at
+// build time: every state gets a small integer id and every (state, char)
+// pair maps directly to the next state, so start-up does no parsing and
+// scanning costs one table load per character.
+typedef uint8_t StateId;
+typedef std::array<StateId, 256> TransitionRow;
+inline constexpr int MAX_STATES = 128;
+inline constexpr int MAX_LINE_WORDS = 32;
+inline constexpr StateId NO_TRANSITION = 0xff;
+
+template <std::size_t N>
+constexpr std::array<char, N> asChars(const unsigned char (&bytes)[N]) {
+  std::array<char, N> chars{};
+  for (std::size_t i = 0; i < N; ++i) {
+    chars[i] = static_cast<char>(bytes[i]);
+  }
+  return chars;
+}
+inline constexpr std::array<char, sizeof(wlp4_dfa)> wlp4_dfa_text = asChars(wlp4_dfa);
+
+constexpr bool isChar(std::string_view s) {
+  return s.length() == 1;
+}
+constexpr bool isRange(std::string_view s) {
+  return s.length() == 3 && s[1] == '-';
+}
+
+constexpr bool isSpaceChar(unsigned char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+constexpr bool isDigitChar(unsigned char c) {
+  return c >= '0' && c <= '9';
+}
+constexpr bool isIdentChar(unsigned char c) {
+  return isDigitChar(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+constexpr TokenKind kindOfState(std::string_view state) {
+  if (state == "ZERO") {
+    return TokenKind::NUM;
+  }
+  if (state.starts_with("seen")) {
+    return TokenKind::ID;
+  }
+  for (int i = 0; i < TOKEN_KIND_COUNT; ++i) {
+    if (state == TOKEN_NAMES[i]) {
+      return static_cast<TokenKind>(i);
+    }
+  }
+  throw "accepting state does not name a token kind";
+}
+
+// Reads the DFA description word by word or line by line.
+class DFAReader {
+  std::string_view text;
+  std::size_t pos = 0;
+public:
+  constexpr explicit DFAReader(std::string_view text) : text(text) {}
+  constexpr std::string_view word() {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n')) {
+      ++pos;
+    }
+    std::size_t start = pos;
+    while (pos < text.size() && text[pos] != ' ' && text[pos] != '\n') {
+      ++pos;
+    }
+    return text.substr(start, pos - start);
+  }
+  constexpr std::string_view line() {
+    std::size_t start = pos;
+    while (pos < text.size() && text[pos] != '\n') {
+      ++pos;
+    }
+    std::string_view s = text.substr(start, pos - start);
+    if (pos < text.size()) {
+      ++pos;
+    }
+    return s;
+  }
+};
+
+struct DFATable {
+  int stateCount = 0;
+  StateId startState = 0;
+  std::array<std::string_view, MAX_STATES> names{};
+  std::array<TokenKind, MAX_STATES> accepts{};
+  std::array<TransitionRow, MAX_STATES> transitions{};
+
+  constexpr StateId stateId(std::string_view name) const {
+    for (int i = 0; i < stateCount; ++i) {
+      if (names[i] == name) {
+        return static_cast<StateId>(i);
+      }
+    }
+    throw "transition refers to an undeclared state";
+  }
+};
+
+constexpr DFATable compileDFA(std::string_view text) {
+  DFATable dfa;
+  DFAReader in(text);
+  // The alphabet is implied by the transitions, skip to the states.
+  while (in.word() != STATES) {}
+  for (std::string_view s = in.word(); s != TRANSITIONS; s = in.word()) {
+    bool accepting = false;
+    if (s.back() == '!' && !isChar(s)) {
+      accepting = true;
+      s.remove_suffix(1);
+    }
+    if (dfa.stateCount == NO_TRANSITION) {
+      throw "too many states";
+    }
+    dfa.names[dfa.stateCount] = s;
+    dfa.accepts[dfa.stateCount] = accepting ? kindOfState(s) : TokenKind::NONE;
+    ++dfa.stateCount;
+  }
+  for (TransitionRow &row : dfa.transitions) {
+    row.fill(NO_TRANSITION);
+  }
+  in.line(); // rest of the transitions header
+  for (std::string_view s = in.line(); s != INPUT; s = in.line()) {
+    std::array<std::string_view, MAX_LINE_WORDS> lineVec{};
+    int words = 0;
+    DFAReader line(s);
+    for (std::string_view w = line.word(); !w.empty(); w = line.word()) {
+      lineVec[words++] = w;
+    }
+    StateId fromState = dfa.stateId(lineVec[0]);
+    StateId toState = dfa.stateId(lineVec[words - 1]);
+    for (int i = 1; i < words - 1; ++i) {
+      std::string_view symbols = lineVec[i];
+      if (isChar(symbols)) {
+        dfa.transitions[fromState][static_cast<unsigned char>(symbols[0])] = toState;
+      } else if (isRange(symbols)) {
+        for (int c = symbols[0]; c <= symbols[2]; ++c) {
+          dfa.transitions[fromState][c] = toState;
+        }
+      }
+    }
+  }
+  return dfa;
+}
+
+// Keywords are the token kinds whose fixed lexeme could also be an ID.
+constexpr bool isKeyword(TokenKind kind) {
+  if (!hasFixedLexeme(kind)) {
+    return false;
+  }
+  for (std::string_view lexeme = TOKEN_LEXEMES[static_cast<int>(kind)]; char c : lexeme) {
+    if (!isIdentChar(c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The DFA spells out every keyword prefix as its own state. Those states
+// only differ in which keyword they may end up accepting, so relabelling
+// them as ID lets minimization fold them all into the ID state; keywords are
+// then told apart after the token is matched (see keywordKind).
+constexpr DFATable collapseKeywords(DFATable dfa) {
+  for (int q = 0; q < dfa.stateCount; ++q) {
+    if (dfa.accepts[q] != TokenKind::NONE && isKeyword(dfa.accepts[q])) {
+      dfa.accepts[q] = TokenKind::ID;
+    }
+  }
+  return dfa;
+}
+
+// Hopcroft's partition refinement. Missing transitions go to an implicit
+// dead state so the automaton is complete; states that can only reach the
+// dead state are dropped along with it. Each block keeps the name of its
+// first state, which for the collapsed keyword states is "ID".
+// Plain arrays are used below because std::array indexing is expensive in
+// constant evaluation and this needs to fit the compiler's default limit.
+constexpr DFATable minimize(const DFATable &dfa) {
+  const int dead = dfa.stateCount;
+  const int n = dfa.stateCount + 1;
+
+  // Characters with identical columns are interchangeable, so splitting
+  // only needs to try one character of each such class.
+  int distinctChars[256] = {};
+  int charClasses = 0;
+  for (int c = 0; c < 256; ++c) {
+    bool seen = false;
+    for (int i = 0; i < charClasses && !seen; ++i) {
+      seen = true;
+      for (int q = 0; q < dead && seen; ++q) {
+        seen = dfa.transitions[q][c] == dfa.transitions[q][distinctChars[i]];
+      }
+    }
+    if (!seen) {
+      distinctChars[charClasses++] = c;
+    }
+  }
+  // next[i][q]: the successor of q on the i-th character class.
+  uint8_t next[256][MAX_STATES + 1] = {};
+  for (int i = 0; i < charClasses; ++i) {
+    for (int q = 0; q < n; ++q) {
+      StateId t = q == dead ? NO_TRANSITION : dfa.transitions[q][distinctChars[i]];
+      next[i][q] = t == NO_TRANSITION ? dead : t;
+    }
+  }
+
+  // Start with one block per token kind plus one for non-accepting states.
+  int block[MAX_STATES + 1] = {};
+  int kindBlock[TOKEN_KIND_COUNT + 1] = {};
+  for (int &b : kindBlock) {
+    b = -1;
+  }
+  int blocks = 0;
+  for (int q = 0; q < n; ++q) {
+    int kind = static_cast<int>(q == dead ? TokenKind::NONE : dfa.accepts[q]);
+    if (kindBlock[kind] < 0) {
+      kindBlock[kind] = blocks++;
+    }
+    block[q] = kindBlock[kind];
+  }
+  int worklist[MAX_STATES + 1] = {};
+  bool waiting[MAX_STATES + 1] = {};
+  int pending = 0;
+  for (int b = 0; b < blocks; ++b) {
+    worklist[pending++] = b;
+    waiting[b] = true;
+  }
+
+  bool inSplitter[MAX_STATES + 1] = {};
+  bool entering[MAX_STATES + 1] = {};
+  int enteringCount[MAX_STATES + 1] = {};
+  int size[MAX_STATES + 1] = {};
+  while (pending > 0) {
+    int splitter = worklist[--pending];
+    waiting[splitter] = false;
+    for (int q = 0; q < n; ++q) {
+      inSplitter[q] = block[q] == splitter;
+    }
+    for (int i = 0; i < charClasses; ++i) {
+      // Split every block into the states that enter the splitter on this
+      // character and the ones that don't.
+      for (int b = 0; b < blocks; ++b) {
+        enteringCount[b] = 0;
+        size[b] = 0;
+      }
+      for (int q = 0; q < n; ++q) {
+        entering[q] = inSplitter[next[i][q]];
+        enteringCount[block[q]] += entering[q];
+        ++size[block[q]];
+      }
+      int oldBlocks = blocks;
+      for (int y = 0; y < oldBlocks; ++y) {
+        if (enteringCount[y] == 0 || enteringCount[y] == size[y]) {
+          continue;
+        }
+        int z = blocks++;
+        for (int q = 0; q < n; ++q) {
+          if (block[q] == y && entering[q]) {
+            block[q] = z;
+          }
+        }
+        if (waiting[y]) {
+          worklist[pending++] = z;
+          waiting[z] = true;
+        } else {
+          int smaller = 2 * enteringCount[y] <= size[y] ? z : y;
+          worklist[pending++] = smaller;
+          waiting[smaller] = true;
+        }
+      }
+    }
+  }
+
+  DFATable min;
+  std::array<int, MAX_STATES + 1> newId{};
+  std::array<int, MAX_STATES> representative{};
+  newId.fill(-1);
+  for (int q = 0; q < dfa.stateCount; ++q) {
+    if (block[q] == block[dead] || newId[block[q]] >= 0) {
+      continue;
+    }
+    newId[block[q]] = min.stateCount;
+    representative[min.stateCount] = q;
+    min.names[min.stateCount] = dfa.names[q];
+    min.accepts[min.stateCount] = dfa.accepts[q];
+    ++min.stateCount;
+  }
+  min.startState = static_cast<StateId>(newId[block[dfa.startState]]);
+  for (int s = 0; s < min.stateCount; ++s) {
+    min.transitions[s].fill(NO_TRANSITION);
+    for (int c = 0; c < 256; ++c) {
+      StateId target = dfa.transitions[representative[s]][c];
+      if (target != NO_TRANSITION && block[target] != block[dead]) {
+        min.transitions[s][c] = static_cast<StateId>(newId[block[target]]);
+      }
+    }
+  }
+  return min;
+}
+
+inline constexpr DFATable WLP4_DFA = minimize(collapseKeywords(
+    compileDFA(std::string_view(wlp4_dfa_text.data(), wlp4_dfa_len))));
+inline constexpr int STATE_COUNT = WLP4_DFA.stateCount;
+inline constexpr StateId START_STATE = WLP4_DFA.startState;
+
+// Perfect hash over the keywords, keyed on the first and last characters
+// and the length.
+inline constexpr int KEYWORD_SLOT_BITS = 5;
+
+constexpr uint32_t keywordKey(std::string_view s) {
+  return static_cast<unsigned char>(s.front()) << 16 | static_cast<unsigned char>(s.back()) << 8 |
+         static_cast<uint32_t>(s.size() & 0xff);
+}
+
+constexpr int countKeywords() {
+  int count = 0;
+  for (int k = 0; k < TOKEN_KIND_COUNT; ++k) {
+    count += isKeyword(static_cast<TokenKind>(k));
+  }
+  return count;
+}
+
+constexpr std::array<PerfectHashEntry<TokenKind>, countKeywords()> keywordEntries() {
+  std::array<PerfectHashEntry<TokenKind>, countKeywords()> entries{};
+  std::size_t i = 0;
+  for (int k = 0; k < TOKEN_KIND_COUNT; ++k) {
+    if (isKeyword(static_cast<TokenKind>(k))) {
+      entries[i++] = {TOKEN_LEXEMES[k], static_cast<TokenKind>(k)};
+    }
+  }
+  return entries;
+}
+inline constexpr auto keywordTable =
+    buildPerfectHash<KEYWORD_SLOT_BITS, keywordKey>(keywordEntries(), TokenKind::NONE);
+
+// The kind of an identifier-shaped lexeme: a keyword kind or ID.
+inline TokenKind keywordKind(std::string_view lexeme) {
+  if (lexeme.size() > keywordTable.maxLength) {
+    return TokenKind::ID;
+  }
+  uint32_t slot = keywordTable.slot(lexeme);
+  std::string_view keyword = keywordTable.names[slot];
+  if (keyword.size() != lexeme.size()) {
+    return TokenKind::ID;
+  }
+  // keywords are short enough that an inline loop beats calling memcmp
+  for (std::size_t i = 0; i < keyword.size(); ++i) {
+    if (keyword[i] != lexeme[i]) {
+      return TokenKind::ID;
+    }
+  }
+  return keywordTable.values[slot];
+}
+
+// Drops the unused rows so only STATE_COUNT states end up in the binary.
+template <typename T>
+constexpr std::array<T, STATE_COUNT> usedStates(const std::array<T, MAX_STATES> &all) {
+  std::array<T, STATE_COUNT> used{};
+  for (int i = 0; i < STATE_COUNT; ++i) {
+    used[i] = all[i];
+  }
+  return used;
+}
+inline constexpr std::array<TransitionRow, STATE_COUNT> transitionTable = usedStates(WLP4_DFA.transitions);
+inline constexpr std::array<TokenKind, STATE_COUNT> acceptTable = usedStates(WLP4_DFA.accepts);
+inline constexpr std::array<std::string_view, STATE_COUNT> stateNames = usedStates(WLP4_DFA.names);
+
+// Character classes whose runs are skipped in bulk instead of one DFA step
+// per character. A state gets a run class when every character of that
+// class loops back to the state itself (ID over [a-zA-Z0-9], NUM over [0-9]).
+enum class RunClass : uint8_t {
+  NONE,
+  IDENT,
+  DIGITS,
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+// Byte-wise lo <= c <= hi. There are only signed byte compares, so the
+// range is first shifted down to start at -128.
+inline __m128i inRange(__m128i v, char lo, char hi) {
+  __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(-128 - lo)));
+  return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo - 127)));
+}
+__attribute__((target("avx2"))) inline __m256i inRange(__m256i v, char lo, char hi) {
+  __m256i shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(-128 - lo)));
+  return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi - lo - 127)), shifted);
+}
+#endif
+
+constexpr std::array<RunClass, STATE_COUNT> computeRunClasses() {
+  std::array<RunClass, STATE_COUNT> classes{};
+  for (int s = 0; s < STATE_COUNT; ++s) {
+    bool identLoop = true;
+    bool digitLoop = true;
+    for (int c = 0; c < 256; ++c) {
+      bool loops = transitionTable[s][c] == s;
+      if (isIdentChar(c) && !loops) identLoop = false;
+      if (isDigitChar(c) && !loops) digitLoop = false;
+    }
+    classes[s] = identLoop ? RunClass::IDENT : digitLoop ? RunClass::DIGITS : RunClass::NONE;
+  }
+  return classes;
+}
+inline constexpr std::array<RunClass, STATE_COUNT> runClassTable = computeRunClasses();
+
+// Run kernels return the first position in [p, end) that is not in their
+// character class. The SIMD versions test 16 or 32 bytes at a time and
+// finish the tail with the scalar loop; the widest one the CPU supports is
+// picked once at start-up.
+typedef const char *(*RunKernel)(const char *p, const char *end);
+
+struct SpaceClass {
+  static bool contains(unsigned char c) { return isSpaceChar(c); }
+#if defined(__x86_64__) || defined(__i386__)
+  static __m128i match(__m128i v) {
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange(v, '\t', '\r'));
+  }
+  __attribute__((target("avx2"))) static __m256i match(__m256i v) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange(v, '\t', '\r'));
+  }
+#endif
+};
+
+struct DigitClass {
+  static bool contains(unsigned char c) { return isDigitChar(c); }
+#if defined(__x86_64__) || defined(__i386__)
+  static __m128i match(__m128i v) { return inRange(v, '0', '9'); }
+  __attribute__((target("avx2"))) static __m256i match(__m256i v) { return inRange(v, '0', '9'); }
+#endif
+};
+
+struct IdentClass {
+  static bool contains(unsigned char c) { return isIdentChar(c); }
+#if defined(__x86_64__) || defined(__i386__)
+  static __m128i match(__m128i v) {
+    // setting bit 5 folds upper case onto lower case
+    __m128i letters = inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+    return _mm_or_si128(letters, inRange(v, '0', '9'));
+  }
+  __attribute__((target("avx2"))) static __m256i match(__m256i v) {
+    __m256i letters = inRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+    return _mm256_or_si256(letters, inRange(v, '0', '9'));
+  }
+#endif
+};
+
+template <typename Class>
+const char *skipRunScalar(const char *p, const char *end) {
+  while (p < end && Class::contains(static_cast<unsigned char>(*p))) {
+    ++p;
+  }
+  return p;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+template <typename Class>
+const char *skipRunSSE2(const char *p, const char *end) {
+  while (end - p >= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(Class::match(v)));
+    if (mask != 0xffff) {
+      return p + __builtin_ctz(~mask);
+    }
+    p += 16;
+  }
+  return skipRunScalar<Class>(p, end);
+}
+
+template <typename Class>
+__attribute__((target("avx2"))) const char *skipRunAVX2(const char *p, const char *end) {
+  while (end - p >= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(Class::match(v)));
+    if (mask != 0xffffffffu) {
+      return p + __builtin_ctz(~mask);
+    }
+    p += 32;
+  }
+  return skipRunSSE2<Class>(p, end);
+}
+#endif
+
+// Most runs are short, so the first few characters are checked inline and
+// only longer runs are handed to the kernel.
+inline constexpr std::ptrdiff_t SHORT_RUN = 2;
+
+template <typename Class>
+inline const char *skipRun(const char *p, const char *end, RunKernel kernel) {
+  const char *shortEnd = end - p > SHORT_RUN ? p + SHORT_RUN : end;
+  for (; p < shortEnd; ++p) {
+    if (!Class::contains(static_cast<unsigned char>(*p))) {
+      return p;
+    }
+  }
+  return p == end ? p : kernel(p, end);
+}
+
+struct RunKernels {
+  RunKernel space;
+  RunKernel ident;
+  RunKernel digits;
+};
+
+inline constexpr RunKernels SCALAR_RUN_KERNELS = {skipRunScalar<SpaceClass>, skipRunScalar<IdentClass>,
+                                                  skipRunScalar<DigitClass>};
+#if defined(__x86_64__) || defined(__i386__)
+inline constexpr RunKernels SSE2_RUN_KERNELS = {skipRunSSE2<SpaceClass>, skipRunSSE2<IdentClass>,
+                                                skipRunSSE2<DigitClass>};
+inline constexpr RunKernels AVX2_RUN_KERNELS = {skipRunAVX2<SpaceClass>, skipRunAVX2<IdentClass>,
+                                                skipRunAVX2<DigitClass>};
+#endif
+
+inline RunKernels selectRunKernels() {
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("avx2")) {
+    return AVX2_RUN_KERNELS;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SSE2_RUN_KERNELS;
+  }
+#endif
+  return SCALAR_RUN_KERNELS;
+}
+// Only wlp4scanbench replaces these, to time each set in turn; nothing may
+// change them while a scan is running.
+inline RunKernels runKernels = selectRunKernels();
+
+// A token is its kind plus a view into the source buffer; scanning never
+// copies lexemes.
+enum class ScanStatus { TOKEN, END, ERROR };
+
+struct Token {
+  TokenKind kind;
+  std::string_view lexeme;
+};
+
+// NUM lexemes never have leading zeros, so the length decides most cases.
+inline bool fitsInInt(std::string_view num) {
+  return num.length() < 10 || (num.length() == 10 && num <= "2147483647");
+}
+class DFA {
+  // Runs the DFA from the start state over one maximal-munch token.
+  // Returns the position after it and leaves the final state in `state`.
+  const char *munch(const char *p, const char *end, StateId &state) const {
+    state = START_STATE;
+    while (p < end) {
+      StateId next = transitionTable[state][static_cast<unsigned char>(*p)];
+      if (next == NO_TRANSITION) {
+        break;
+      }
+      state = next;
+      ++p;
+      switch (runClassTable[state]) {
+      case RunClass::IDENT:
+        p = skipRun<IdentClass>(p, end, runKernels.ident);
+        break;
+      case RunClass::DIGITS:
+        p = skipRun<DigitClass>(p, end, runKernels.digits);
+        break;
+      case RunClass::NONE:
+        break;
+      }
+    }
+    return p;
+  }
+public:
+  // Finds the token at or after `p`, which must be a token boundary, and
+  // advances `p` past it. Tokens never span whitespace, and `//` at a token
+  // boundary starts a comment that runs to the end of the line. On ERROR
+  // the message is left in `error`.
+  ScanStatus next(const char *&p, const char *end, Token &token, std::string &error) const {
+    while (true) {
+      p = skipRun<SpaceClass>(p, end, runKernels.space);
+      if (p == end) {
+        return ScanStatus::END;
+      }
+      if (*p != '/' || end - p == 1 || p[1] != '/') {
+        break;
+      }
+      p = static_cast<const char *>(std::memchr(p, '\n', end - p));
+      if (p == nullptr) {
+        p = end;
+        return ScanStatus::END;
+      }
+    }
+    StateId state;
+    const char *start = p;
+    p = munch(p, end, state);
+    TokenKind kind = acceptTable[state];
+    if (kind == TokenKind::NONE) {
+      if (p == end || isSpaceChar(static_cast<unsigned char>(*p))) {
+        error = "incomplete input";
+      } else {
+        error = "invalid token, state: " + std::string(stateNames[state]) + ", char: " + *p;
+      }
+      return ScanStatus::ERROR;
+    }
+    token = Token{kind, std::string_view(start, p - start)};
+    if (kind == TokenKind::ID) {
+      token.kind = keywordKind(token.lexeme);
+    }
+    if (kind == TokenKind::NUM && !fitsInInt(token.lexeme)) {
+      error = "number out of range";
+      return ScanStatus::ERROR;
+    }
+    return ScanStatus::TOKEN;
+  }
+
+  // Scans the whole input, handing each token to `emit`.
+  template <typename Emit>
+  bool scan(std::string_view source, Emit &&emit, std::string &error) const {
+    const char *p = source.data();
+    const char *end = p + source.size();
+    Token token;
+    ScanStatus status;
+    while ((status = next(p, end, token, error)) == ScanStatus::TOKEN) {
+      emit(token);
+    }
+    return status == ScanStatus::END;
+  }
+};
+
+// A token by position, so that it stays meaningful while the text changes.
+struct LexedToken {
+  TokenKind kind;
+  std::size_t offset;
+  std::size_t length;
+  std::size_t end() const { return offset + length; }
+};
+
+// Which tokens an edit replaced: old tokens [first, first + removed) became
+// the new tokens [first, first + inserted).
+struct TokenRange {
+  std::size_t first;
+  std::size_t removed;
+  std::size_t inserted;
+};
+
+// Keeps a text and its tokens up to date under edits. An edit is re-lexed
+// from the end of the last token that lies wholly before it; once a new
+// token starts past the edited bytes at the shifted start of an old token,
+// both scans are at the same boundary over the same suffix and the old
+// tokens from there on are reused with their offsets moved.
+class IncrementalScanner {
+  const DFA &dfa;
+  std::string source;
+  std::vector<LexedToken> lexed;
+  std::string scanError;
+
+  // Re-lexes source from `restart`. Stops at the first token that starts at
+  // or past `editEnd` where an old token from `last` on starts `delta`
+  // bytes earlier, leaving `last` at that old token (or at the end).
+  std::vector<LexedToken> relex(std::size_t restart, std::size_t editEnd, std::ptrdiff_t delta,
+                                std::size_t &last, bool &resynced) {
+    std::vector<LexedToken> fresh;
+    const char *base = source.data();
+    const char *p = base + restart;
+    const char *end = base + source.size();
+    std::string error;
+    Token token;
+    resynced = false;
+    ScanStatus status;
+    while ((status = dfa.next(p, end, token, error)) == ScanStatus::TOKEN) {
+      std::size_t start = token.lexeme.data() - base;
+      if (start >= editEnd) {
+        while (last < lexed.size() && static_cast<std::ptrdiff_t>(lexed[last].offset) + delta <
+                                          static_cast<std::ptrdiff_t>(start)) {
+          ++last;
+        }
+        if (last < lexed.size() && lexed[last].offset + delta == start) {
+          resynced = true;
+          return fresh;
+        }
+      }
+      fresh.push_back({token.kind, start, token.lexeme.size()});
+    }
+    last = lexed.size();
+    scanError = status == ScanStatus::ERROR ? error : std::string();
+    return fresh;
+  }
+public:
+  IncrementalScanner(const DFA &dfa, std::string text) : dfa(dfa), source(std::move(text)) {
+    std::size_t last = 0;
+    bool resynced;
+    lexed = relex(0, 0, 0, last, resynced);
+  }
+  // Replaces `removed` bytes at `offset` with `inserted` and re-lexes the
+  // affected tokens.
+  TokenRange edit(std::size_t offset, std::size_t removed, std::string_view inserted) {
+    source.replace(offset, removed, inserted);
+    std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(inserted.size()) - static_cast<std::ptrdiff_t>(removed);
+    // A token ending right at the edit may grow into it, so it is re-lexed
+    // too; the one before it ends at an untouched byte that stopped it.
+    auto firstChanged = std::partition_point(lexed.begin(), lexed.end(),
+                                             [offset](const LexedToken &t) { return t.end() < offset; });
+    std::size_t first = firstChanged - lexed.begin();
+    std::size_t restart = first == 0 ? 0 : lexed[first - 1].end();
+    std::size_t last = first;
+    bool resynced;
+    std::vector<LexedToken> fresh = relex(restart, offset + inserted.size(), delta, last, resynced);
+    for (std::size_t i = last; i < lexed.size(); ++i) {
+      lexed[i].offset += delta;
+    }
+    TokenRange range{first, last - first, fresh.size()};
+    lexed.erase(lexed.begin() + first, lexed.begin() + last);
+    lexed.insert(lexed.begin() + first, fresh.begin(), fresh.end());
+    return range;
+  }
+  const std::string &text() const { return source; }
+  const std::vector<LexedToken> &tokens() const { return lexed; }
+  std::string_view lexeme(const LexedToken &token) const {
+    return std::string_view(source).substr(token.offset, token.length);
+  }
+  // Scanning stops at the first error, so tokens() then ends before it.
+  bool ok() const { return scanError.empty(); }
+  const std::string &error() const { return scanError; }
+};
+
+#endif
@@ -1,20 +1,73 @@
+#include "../common/wlp4flattree.h"
+#include "../common/wlp4intern.h"
+#include "../common/wlp4jobs.h"
+#include "../common/wlp4production.h"
+#include "../common/wlp4scope.h"
+#include "../common/wlp4tree.h"
+#include "../common/wlp4treetext.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
-#include <map>
+#include <iterator>
 #include <memory>
-#include <set>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
-enum class wlp4Type {
+enum class wlp4Type : uint8_t {
     INT,
     PTR,
     UNKNOWN,
+    ERROR, // a node whose check failed; checks that use it are skipped
+};
+// Every lexeme in the tree is interned as it is read; scopes, variables and
+// procedures are keyed by symbol id.
+Interner symbols;
+const SymbolId WAIN_SCOPE = symbols.intern("wain");
+
+// A procedure's signature and the types of its variables by slot. Slots
+// number the parameters, then the dcls, in declaration order.
+struct Procedure {
+    SymbolId name;
+    std::vector<wlp4Type> signature;
+    ScopeTable variables;
+    std::vector<wlp4Type> types;
+};
+
+// The procedures in declaration order, found by name through `names`; wain
+// is declared as "wain", which no ID can spell. A procedure whose name is
+// taken is kept, so that its body is checked too, but has no slot. All of
+// them are declared, with their signatures, before any body is checked.
+struct Tables {
+    ScopeTable names;
+    std::vector<int> procedureOf; // by slot in names
+    std::vector<Procedure> procedures;
+};
+
+// One problem found by the checker.
+struct Diagnostic {
+    const char *kind; // "invalid type" or "semantic error"
+    SymbolId procedure;
+    NodeId node;
+    std::string message;
+};
+
+// What checking one procedure body needs. Bodies are checked as separate
+// tasks, each with its own Context; a task only changes its own procedure
+// and collects its own diagnostics, in the order it finds them.
+struct Context {
+    Tables &tables;
+    int scope; // the procedure's index
+    std::vector<Diagnostic> diagnostics = {};
+
+    Procedure &procedure() const {
+        return tables.procedures[scope];
+    }
+    void report(const char *kind, NodeId node, std::string message) {
+        diagnostics.push_back({kind, procedure().name, node, std::move(message)});
+    }
 };
-typedef std::map<std::string, std::map<std::string, wlp4Type>> Tables;
-typedef std::map<std::string, std::vector<wlp4Type>> ProcTable;
-ProcTable activeSignature = std::map<std::string, std::vector<wlp4Type>>{};
-std::string scope;
 
 std::string getTypeString(wlp4Type type) {
     switch (type) {
@@ -24,451 +77,638 @@ std::string getTypeString(wlp4Type type) {
         return "int*";
     case wlp4Type::UNKNOWN:
         return "unknown";
+    case wlp4Type::ERROR:
+        return "error";
     }
     return "unknown";
 }
 
-const std::set<std::string> terminalSymbol = {
-    "ID",
-    "NUM",
-    "LPAREN",
-    "RPAREN",
-    "LBRACE",
-    "RBRACE",
-    "RETURN",
-    "IF",
-    "ELSE",
-    "WHILE",
-    "PRINTLN",
-    "PUTCHAR",
-    "GETCHAR",
-    "WAIN",
-    "BECOMES",
-    "INT",
-    "EQ",
-    "NE",
-    "LT",
-    "GT",
-    "LE",
-    "GE",
-    "PLUS",
-    "MINUS",
-    "STAR",
-    "SLASH",
-    "PCT",
-    "COMMA",
-    "SEMI",
-    "NEW",
-    "DELETE",
-    "LBRACK",
-    "RBRACK",
-    "AMP",
-    "NULL",
-    "BOF",
-    "EOF",
-};
+wlp4Type fromTreeType(TreeType type) {
+    switch (type) {
+    case TreeType::INT:
+        return wlp4Type::INT;
+    case TreeType::PTR:
+        return wlp4Type::PTR;
+    case TreeType::NONE:
+        return wlp4Type::UNKNOWN;
+    }
+    return wlp4Type::UNKNOWN;
+}
 
-bool isTerminal(const std::string &token) {
-    return terminalSymbol.contains(token);
+TreeType toTreeType(wlp4Type type) {
+    switch (type) {
+    case wlp4Type::INT:
+        return TreeType::INT;
+    case wlp4Type::PTR:
+        return TreeType::PTR;
+    case wlp4Type::UNKNOWN:
+    case wlp4Type::ERROR:
+        return TreeType::NONE;
+    }
+    return TreeType::NONE;
 }
 
 void outputError(std::string msg = "") {
     std::cerr << "ERROR: " << msg << std::endl;
 }
 
-struct Node {
-    std::string lhs = "";
-    std::string lexeme = "";
-    wlp4Type type = wlp4Type::UNKNOWN;
-    std::vector<std::unique_ptr<Node>> children = {};
-    std::string getRhsString() {
-        if (children.empty()) {
-            return lexeme;
-        }
-        std::string rhs = children[0]->lhs;
-        for (size_t i = 1; i < children.size(); ++i) {
-            rhs += " " + children[i]->lhs;
-        }
-        return rhs;
-    }
+// How fillType types a node: which of its children it types, in order, and
+// how it combines their types.
+enum class Typing {
+    KEEP,      // no children; the node keeps its type
+    ALL,       // every child, for their side effects; the result is unknown
+    COPY,      // one child, whose type the node takes
+    SUM,       // expr PLUS/MINUS term
+    PRODUCT,   // term STAR/SLASH/PCT factor
+    ADDRESS,   // AMP lvalue
+    DEREF,     // STAR factor
+    ALLOC,     // NEW INT LBRACK expr RBRACK
+    CALL,      // ID LPAREN RPAREN
+    CALL_ARGS, // ID LPAREN arglist RPAREN: each argument expr
+    GETCHAR,
+    PROCEDURE, // the dcls, statements and return expr
+};
 
-    explicit Node(std::string lhs) : lhs(lhs) {}
-    void populate(std::istream &in) {
-        std::string read;
-        getline(in, read);
-        std::istringstream iss{read};
-        iss >> read;
-        if (isTerminal(read)) {
-            // leaf node
-            iss >> lexeme;
-            return;
-        }
-        while (iss >> read) {
-            if (read == ".EMPTY") {
-                lexeme = ".EMPTY";
-                return;
+// A node on fillType's explicit stack.
+struct TypeFrame {
+    NodeId node;
+    Typing typing = Typing::KEEP;
+    int child = 0;         // COPY, ADDRESS, DEREF, ALLOC: the child typed
+    size_t visited = 0;    // children typed so far
+    NodeId next = NO_NODE; // ALL: the next child; CALL_ARGS: the arguments not yet typed
+    size_t base = 0;       // where the children's types start on the result stack
+};
+
+class Tree {
+    FlatTree<wlp4Type> nodes;
+    Tables tables;
+    bool wellFormed;
+
+    // Reads the tree in pre-order, one node per line. false if a line is
+    // neither a leaf nor a WLP4 rule, is not the symbol its parent's rule
+    // has there, or the input ends first.
+    bool populate(TextTreeReader &in) {
+        nodes.reserve(in.linesLeft());
+        TextTreeLine line;
+        while (!nodes.complete()) {
+            if (!in.next(line) || !nodes.fits(line.production, line.code)) {
+                return false;
+            }
+            if (line.production == Production::NONE) {
+                nodes.appendLeaf(line.code, symbols.intern(line.lexeme), fromTreeType(line.type));
+            } else {
+                nodes.appendInner(line.production, fromTreeType(line.type));
             }
-            children.emplace_back(std::make_unique<Node>(read));
-        }
-        for (auto &child : children) {
-            child->populate(in);
         }
+        return true;
     }
-    void processParams(Tables &tables) {
-        if (lhs != "params") {
-            return;
-        }
-        if (children.empty()) {
-            return;
-        }
-        if (getRhsString() == "paramlist") {
-            children[0]->processParamList(tables);
+    bool populate(TreeReader &in) {
+        std::vector<Production> productions = treeProductions(in.rules());
+        TreeRecord record;
+        while (!nodes.complete()) {
+            if (!in.next(record)) {
+                return false;
+            }
+            if (record.leaf) {
+                if (!nodes.fits(Production::NONE, record.code)) {
+                    return false;
+                }
+                nodes.appendLeaf(record.code, record.lexeme, fromTreeType(record.type));
+                continue;
+            }
+            if (productions[record.ruleId] == Production::NONE ||
+                !nodes.fits(productions[record.ruleId], TREE_INNER)) {
+                return false;
+            }
+            nodes.appendInner(productions[record.ruleId], fromTreeType(record.type));
         }
+        return true;
     }
-    void processParamList(Tables &tables) {
-        if (lhs != "paramlist") {
-            return;
+    void processParams(NodeId params, Context &context) {
+        if (nodes.rules[params] == Production::PARAMS_LIST) {
+            processParamList(nodes.child(params, 0), context);
         }
-        if (getRhsString() == "dcl COMMA paramlist") {
-            Node *dcl = children[0].get();
-            Node *dclType = dcl->children[0].get();
-            if (dclType->getRhsString() == "INT") {
-                activeSignature[scope].emplace_back(wlp4Type::INT);
-            } else if (dclType->getRhsString() == "INT STAR") {
-                activeSignature[scope].emplace_back(wlp4Type::PTR);
+    }
+    // paramlist is right-recursive; it is walked as a list.
+    void processParamList(NodeId list, Context &context) {
+        while (list != NO_NODE) {
+            Production rule = nodes.rules[list];
+            if (rule != Production::PARAMLIST_DCL && rule != Production::PARAMLIST_MORE) {
+                return;
             }
-            dcl->processDeclaration(tables);
-            children[2]->processParamList(tables);
-        } else if (getRhsString() == "dcl") {
-            Node *dcl = children[0].get();
-            Node *dclType = dcl->children[0].get();
-            if (dclType->getRhsString() == "INT") {
-                activeSignature[scope].emplace_back(wlp4Type::INT);
-            } else if (dclType->getRhsString() == "INT STAR") {
-                activeSignature[scope].emplace_back(wlp4Type::PTR);
+            NodeId dcl = nodes.child(list, 0);
+            Production dclType = nodes.rules[nodes.child(dcl, 0)];
+            if (dclType == Production::TYPE_INT) {
+                context.procedure().signature.emplace_back(wlp4Type::INT);
+            } else if (dclType == Production::TYPE_INT_STAR) {
+                context.procedure().signature.emplace_back(wlp4Type::PTR);
             }
-            dcl->processDeclaration(tables);
+            processDeclaration(dcl, context);
+            list = rule == Production::PARAMLIST_DCL ? NO_NODE : nodes.child(list, 2);
         }
     }
-    void processDeclaration(Tables &tables) {
-        if (lhs == "dcl" && getRhsString() == "type ID") {
-            wlp4Type dclType = wlp4Type::UNKNOWN;
-            if (children[0]->getRhsString() == "INT") {
-                dclType = wlp4Type::INT;
-            } else if (children[0]->getRhsString() == "INT STAR") {
-                dclType = wlp4Type::PTR;
-            }
-            if (tables[scope].contains(children[1]->lexeme)) {
-                throw std::exception();
-            }
-            tables[scope][children[1]->lexeme] = dclType;
-            children[1]->type = dclType;
-        } else if (lhs == "procedure" && getRhsString() == "INT ID LPAREN params RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE") {
-            if (activeSignature.contains(children[1]->lexeme)) {
-                throw std::exception();
-            }
-            activeSignature[children[1]->lexeme] = {};
-            scope = children[1]->lexeme;
-            children[3]->processParams(tables);
+    // Declares a dcl's ID in the context's procedure.
+    void processDeclaration(NodeId dcl, Context &context) {
+        wlp4Type dclType = wlp4Type::UNKNOWN;
+        Production typeRule = nodes.rules[nodes.child(dcl, 0)];
+        if (typeRule == Production::TYPE_INT) {
+            dclType = wlp4Type::INT;
+        } else if (typeRule == Production::TYPE_INT_STAR) {
+            dclType = wlp4Type::PTR;
+        }
+        Procedure &procedure = context.procedure();
+        NodeId id = nodes.child(dcl, 1);
+        SymbolId name = nodes.lexemes[id];
+        int slot = procedure.variables.declare(name);
+        nodes.types[id] = dclType;
+        if (slot < 0) {
+            context.report("invalid type", dcl, "variable " + std::string(symbols.name(name)) + " is already declared");
+            return;
         }
+        procedure.types.push_back(dclType);
+        nodes.slots[id] = slot;
     }
-    void findDeclarations(Tables &tables) {
-        if (lhs == "dcl" && getRhsString() == "type ID") {
-            processDeclaration(tables);
+    // Declares a procedure, and a procedure's parameters, as the start of
+    // the sequential pass. wain has no params node.
+    Context declareProcedure(SymbolId name, NodeId procedure, NodeId params) {
+        Context context{tables, static_cast<int>(tables.procedures.size())};
+        tables.procedures.push_back(Procedure{name, {}, {}, {}});
+        if (tables.names.declare(name) < 0) {
+            context.report("invalid type", procedure, "procedure " + std::string(symbols.name(name)) + " is already declared");
         } else {
-            for (auto &child : children) {
-                child->findDeclarations(tables);
-            }
+            tables.procedureOf.push_back(context.scope);
         }
+        if (params != NO_NODE) {
+            processParams(params, context);
+        }
+        return context;
     }
 
-    bool semanticCheck() {
-        if (children.empty()) {
-            return true;
+    // Checks the semantic rules over the subtree, reporting every rule it
+    // breaks. An operand whose typing failed has been reported already.
+    void semanticCheck(NodeId root, Context &context) {
+        for (NodeId node = root; node < nodes.ends[root]; ++node) {
+            checkRule(node, context);
         }
-        if (lhs == "main" && getRhsString() == "INT WAIN LPAREN dcl COMMA dcl RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE") {
-            Node *dcl1 = children[3].get();
-            Node *dcl2 = children[5].get();
-            Node *dcl1Id = dcl1->children[1].get();
-            Node *dcl2Id = dcl2->children[1].get();
-            Node *returnExp = children[11].get();
-            if (dcl2Id->type != wlp4Type::INT) {
-                return false;
-            }
-            if (dcl1Id->lexeme == dcl2Id->lexeme) {
-                return false;
-            }
-            if (returnExp->type != wlp4Type::INT) {
-                return false;
+    }
+    // The semantic rules on this node alone.
+    void checkRule(NodeId node, Context &context) {
+        Production rule = nodes.rules[node];
+        auto failed = [&](NodeId operand) {
+            return nodes.types[operand] == wlp4Type::ERROR;
+        };
+        auto requireType = [&](NodeId operand, wlp4Type expected, const std::string &what) {
+            if (!failed(operand) && nodes.types[operand] != expected) {
+                context.report("semantic error", node,
+                               what + " must be " + getTypeString(expected) + ", not " + getTypeString(nodes.types[operand]));
             }
-        }
-        if (lhs == "statement") {
-            if (getRhsString() == "lvalue BECOMES expr SEMI") {
-                if (children[0]->type != children[2]->type) {
-                    return false;
-                }
-            } else if (getRhsString() == "PRINTLN LPAREN expr RPAREN SEMI" ||
-                       getRhsString() == "PUTCHAR LPAREN expr RPAREN SEMI") {
-                if (children[2]->type != wlp4Type::INT) {
-                    return false;
-                }
-            } else if (getRhsString() == "DELETE LBRACK RBRACK expr SEMI") {
-                if (children[3]->type != wlp4Type::PTR) {
-                    return false;
-                }
+        };
+        switch (rule) {
+        case Production::MAIN:
+            // Parameters with the same name are reported as a redeclaration.
+            requireType(nodes.child(nodes.child(node, 5), 1), wlp4Type::INT, "the second parameter of wain");
+            requireType(nodes.child(node, 11), wlp4Type::INT, "the return value of wain");
+            break;
+        case Production::STATEMENT_ASSIGN:
+        case Production::TEST_EQ:
+        case Production::TEST_NE:
+        case Production::TEST_LT:
+        case Production::TEST_LE:
+        case Production::TEST_GE:
+        case Production::TEST_GT: {
+            NodeId left = nodes.child(node, 0);
+            NodeId right = nodes.child(node, 2);
+            if (!failed(left) && !failed(right) && nodes.types[left] != nodes.types[right]) {
+                context.report("semantic error", node,
+                               std::string(rule == Production::STATEMENT_ASSIGN ? "cannot assign " : "cannot compare ") +
+                                   getTypeString(nodes.types[right]) +
+                                   (rule == Production::STATEMENT_ASSIGN ? " to " : " and ") +
+                                   getTypeString(nodes.types[left]));
             }
+            break;
         }
-        if (lhs == "test" && children.size() == 3) {
-            if (children[0]->type != children[2]->type) {
-                return false;
-            }
+        case Production::STATEMENT_PRINTLN:
+            requireType(nodes.child(node, 2), wlp4Type::INT, "the argument of println");
+            break;
+        case Production::STATEMENT_PUTCHAR:
+            requireType(nodes.child(node, 2), wlp4Type::INT, "the argument of putchar");
+            break;
+        case Production::STATEMENT_DELETE:
+            requireType(nodes.child(node, 3), wlp4Type::PTR, "the argument of delete");
+            break;
+        case Production::DCLS_NUM:
+            requireType(nodes.child(nodes.child(node, 1), 1), wlp4Type::INT, "a variable initialized with a number");
+            break;
+        case Production::DCLS_NULL:
+            requireType(nodes.child(nodes.child(node, 1), 1), wlp4Type::PTR, "a variable initialized with NULL");
+            break;
+        default:
+            break;
         }
-        if (lhs == "dcls") {
-            if (getRhsString() == "dcls dcl BECOMES NUM SEMI") {
-                Node *dcl = children[1].get();
-                Node *dclId = dcl->children[1].get();
-                if (dclId->type != wlp4Type::INT) {
-                    return false;
+    }
+
+    // The part of typing a node that comes before its children are typed:
+    // declarations, scope changes and leaf types.
+    TypeFrame enterType(NodeId node, Context &context) {
+        TypeFrame frame{node};
+        frame.next = node + 1;
+        switch (nodes.rules[node]) {
+        case Production::NONE:
+            if (nodes.is(node, TokenKind::NUM)) {
+                nodes.types[node] = wlp4Type::INT;
+            } else if (nodes.is(node, TokenKind::NULL_)) {
+                nodes.types[node] = wlp4Type::PTR;
+            } else if (nodes.is(node, TokenKind::ID)) {
+                const Procedure &procedure = context.procedure();
+                int slot = procedure.variables.find(nodes.lexemes[node]);
+                nodes.slots[node] = slot;
+                if (slot >= 0) {
+                    nodes.types[node] = procedure.types[slot];
                 }
             }
-            if (getRhsString() == "dcls dcl BECOMES NULL SEMI") {
-                Node *dcl = children[1].get();
-                Node *dclId = dcl->children[1].get();
-                if (dclId->type != wlp4Type::PTR) {
-                    return false;
-                }
+            break;
+        case Production::FACTOR_ID:
+        case Production::LVALUE_ID: {
+            // An undeclared variable takes the error type, so the operators
+            // above it do not report it again.
+            NodeId id = nodes.child(node, 0);
+            if (context.procedure().variables.find(nodes.lexemes[id]) < 0) {
+                reject(id, context, "variable " + std::string(symbols.name(nodes.lexemes[id])) + " is not declared");
             }
+            frame.typing = Typing::COPY;
+            break;
         }
-        for (auto &child : children) {
-            if (!child->semanticCheck()) {
-                return false;
-            }
+        case Production::PROCEDURE:
+            frame.typing = Typing::PROCEDURE;
+            break;
+        case Production::DCL:
+            processDeclaration(node, context);
+            frame.typing = Typing::ALL;
+            break;
+        case Production::FACTOR_PARENS:
+        case Production::LVALUE_PARENS:
+            frame.typing = Typing::COPY;
+            frame.child = 1;
+            break;
+        case Production::EXPR_PLUS:
+        case Production::EXPR_MINUS:
+            frame.typing = Typing::SUM;
+            break;
+        case Production::TERM_STAR:
+        case Production::TERM_SLASH:
+        case Production::TERM_PCT:
+            frame.typing = Typing::PRODUCT;
+            break;
+        case Production::FACTOR_AMP:
+            frame.typing = Typing::ADDRESS;
+            frame.child = 1;
+            break;
+        case Production::FACTOR_STAR:
+        case Production::LVALUE_STAR:
+            frame.typing = Typing::DEREF;
+            frame.child = 1;
+            break;
+        case Production::FACTOR_NEW:
+            frame.typing = Typing::ALLOC;
+            frame.child = 3;
+            break;
+        case Production::FACTOR_CALL:
+            frame.typing = Typing::CALL;
+            break;
+        case Production::FACTOR_CALL_ARGS:
+            frame.typing = Typing::CALL_ARGS;
+            frame.next = nodes.child(node, 2);
+            break;
+        case Production::FACTOR_GETCHAR:
+            frame.typing = Typing::GETCHAR;
+            break;
+        default: {
+            // Unit rules take their child's type; .EMPTY rules keep theirs.
+            int count = nodes.childCount(node);
+            frame.typing = count == 1 ? Typing::COPY : count == 0 ? Typing::KEEP : Typing::ALL;
+            break;
         }
-        return true;
-    }
-    bool compareArgs(std::vector<wlp4Type> &signature, Tables &tables) {
-        if (lhs != "arglist") {
-            return false;
         }
-        if (getRhsString() == "expr") {
-            if (signature.size() != 1 || children[0]->fillType(tables) != signature[0]) {
-                return false;
+        return frame;
+    }
+    // The next child of the frame's node to type, or NO_NODE once the
+    // frame's children are all typed.
+    NodeId nextChild(TypeFrame &frame) {
+        static constexpr int PROCEDURE_CHILDREN[] = {6, 7, 9};
+        switch (frame.typing) {
+        case Typing::ALL: {
+            if (frame.next == nodes.ends[frame.node]) {
+                return NO_NODE;
             }
-            return true;
-        } else if (getRhsString() == "expr COMMA arglist") {
-            if (signature.empty()) {
-                return false;
+            NodeId child = frame.next;
+            frame.next = nodes.ends[child];
+            ++frame.visited;
+            return child;
+        }
+        case Typing::COPY:
+        case Typing::ADDRESS:
+        case Typing::DEREF:
+        case Typing::ALLOC:
+            if (frame.visited > 0) {
+                return NO_NODE;
             }
-            if (children[0]->fillType(tables) != signature[0]) {
-                return false;
+            ++frame.visited;
+            return nodes.child(frame.node, frame.child);
+        case Typing::SUM:
+        case Typing::PRODUCT:
+            return frame.visited < 2 ? nodes.child(frame.node, 2 * frame.visited++) : NO_NODE;
+        case Typing::PROCEDURE:
+            return frame.visited < 3 ? nodes.child(frame.node, PROCEDURE_CHILDREN[frame.visited++]) : NO_NODE;
+        case Typing::CALL_ARGS: {
+            // arglist is right-recursive: expr, or expr COMMA arglist.
+            NodeId arglist = frame.next;
+            if (arglist == NO_NODE ||
+                (nodes.rules[arglist] != Production::ARGLIST_EXPR && nodes.rules[arglist] != Production::ARGLIST_MORE)) {
+                return NO_NODE;
             }
-            std::vector<wlp4Type> nextSignature = std::vector<wlp4Type>(signature.begin() + 1, signature.end());
-            return children[2]->compareArgs(nextSignature, tables);
+            frame.next = nodes.rules[arglist] == Production::ARGLIST_MORE ? nodes.child(arglist, 2) : NO_NODE;
+            ++frame.visited;
+            return nodes.child(arglist, 0);
         }
-        return false;
-    }
-    wlp4Type fillType(Tables &tables) {
-        if (lhs == "main") {
-            scope = "wain";
+        default:
+            return NO_NODE;
         }
-        if ((lhs == "dcl" && getRhsString() == "type ID") || lhs == "procedure") {
-            processDeclaration(tables);
-            if (lhs == "procedure" && getRhsString() == "INT ID LPAREN params RPAREN LBRACE dcls statements RETURN expr SEMI RBRACE") {
-                Node *dcls = children[6].get();
-                Node *statements = children[7].get();
-                Node *returnExp = children[9].get();
-                dcls->typeCheck(tables);
-                statements->typeCheck(tables);
-                returnExp->typeCheck(tables);
-                if (returnExp->type != wlp4Type::INT) {
-                    throw std::exception();
-                }
-                return type;
-            }
+    }
+    // The rest of typing a node, once the children the frame names are
+    // typed; `types` holds their types in order.
+    wlp4Type finishType(const TypeFrame &frame, const wlp4Type *types, Context &context) {
+        NodeId node = frame.node;
+        Production rule = nodes.rules[node];
+        wlp4Type &type = nodes.types[node];
+        // A child that failed has been reported; checking this node too would
+        // only repeat it.
+        if (frame.typing != Typing::ALL && frame.typing != Typing::CALL_ARGS &&
+            std::find(types, types + frame.visited, wlp4Type::ERROR) != types + frame.visited) {
+            type = wlp4Type::ERROR;
+            return type;
         }
-        if (children.empty()) {
-            if (lhs == "NUM") {
-                type = wlp4Type::INT;
-            } else if (lhs == "NULL") {
-                type = wlp4Type::PTR;
-            } else if (lhs == "ID" && tables[scope].contains(lexeme)) {
-                type = tables[scope][lexeme];
-            }
-        } else if (children.size() == 1) {
-            type = children[0]->fillType(tables);
-        } else if (lhs == "factor" && getRhsString() == "LPAREN expr RPAREN") {
-            type = children[1]->fillType(tables);
-        } else if (lhs == "expr" && children.size() == 3 && children[0]->lhs == "expr" && children[2]->lhs == "term") {
-            wlp4Type exprType = children[0]->fillType(tables);
-            wlp4Type termType = children[2]->fillType(tables);
+        switch (frame.typing) {
+        case Typing::KEEP:
+            return type;
+        case Typing::ALL:
+            return wlp4Type::UNKNOWN;
+        case Typing::COPY:
+            type = types[0];
+            return type;
+        case Typing::SUM: {
+            wlp4Type exprType = types[0];
+            wlp4Type termType = types[1];
             if (exprType == wlp4Type::INT && termType == wlp4Type::INT) {
                 type = wlp4Type::INT;
-                return wlp4Type::INT;
             } else if (((exprType == wlp4Type::PTR && termType == wlp4Type::INT) ||
                         (exprType == wlp4Type::INT && termType == wlp4Type::PTR)) &&
-                       children[1]->lhs == "PLUS") {
+                       rule == Production::EXPR_PLUS) {
                 type = wlp4Type::PTR;
-                return wlp4Type::PTR;
             } else if ((exprType == wlp4Type::PTR && termType == wlp4Type::INT) &&
-                       children[1]->lhs == "MINUS") {
+                       rule == Production::EXPR_MINUS) {
                 type = wlp4Type::PTR;
-                return wlp4Type::PTR;
-            } else if (exprType == wlp4Type::PTR && termType == wlp4Type::PTR && children[1]->lhs == "MINUS") {
+            } else if (exprType == wlp4Type::PTR && termType == wlp4Type::PTR && rule == Production::EXPR_MINUS) {
                 type = wlp4Type::INT;
-                return wlp4Type::INT;
             } else {
-                throw std::exception();
+                return reject(node, context, "invalid operands to " + std::string(rule == Production::EXPR_PLUS ? "+" : "-") +
+                                                 ": " + getTypeString(exprType) + " and " + getTypeString(termType));
             }
-        } else if (lhs == "term" && children.size() == 3 && children[0]->lhs == "term" && children[2]->lhs == "factor") {
-            wlp4Type termType = children[0]->fillType(tables);
-            wlp4Type factorType = children[2]->fillType(tables);
-            if (termType == wlp4Type::INT && factorType == wlp4Type::INT) {
-                type = wlp4Type::INT;
-                return wlp4Type::INT;
-            } else {
-                throw std::exception();
+            return type;
+        }
+        case Typing::PRODUCT:
+            if (types[0] != wlp4Type::INT || types[1] != wlp4Type::INT) {
+                const char *op = rule == Production::TERM_STAR ? "*" : rule == Production::TERM_SLASH ? "/" : "%";
+                return reject(node, context, "invalid operands to " + std::string(op) + ": " + getTypeString(types[0]) +
+                                                 " and " + getTypeString(types[1]));
             }
-        } else if (lhs == "factor") {
-            if (getRhsString() == "AMP lvalue") {
-                Node *lvalue = children[1].get();
-                wlp4Type lvalueType = lvalue->fillType(tables);
-                if (lvalueType == wlp4Type::INT) {
-                    type = wlp4Type::PTR;
-                    return wlp4Type::PTR;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "STAR factor") {
-                // The type of a factor or lvalue deriving STAR factor is int. The type of the derived factor (i.e. the one preceded by STAR) must be int*.
-                Node *factor = children[1].get();
-                wlp4Type factorType = factor->fillType(tables);
-                if (factorType == wlp4Type::PTR) {
-                    type = wlp4Type::INT;
-                    return wlp4Type::INT;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "NEW INT LBRACK expr RBRACK") {
-                Node *expr = children[3].get();
-                wlp4Type exprType = expr->fillType(tables);
-                if (exprType == wlp4Type::INT) {
-                    type = wlp4Type::PTR;
-                    return wlp4Type::PTR;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "ID LPAREN RPAREN") {
-                Node *id = children[0].get();
-                if (tables[scope].contains(id->lexeme)) {
-                    throw std::exception();
-                }
-                if (activeSignature.contains(id->lexeme) && activeSignature[id->lexeme].empty()) {
-                    type = wlp4Type::INT;
-                    return wlp4Type::INT;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "ID LPAREN arglist RPAREN") {
-                if (tables[scope].contains(children[0]->lexeme)) {
-                    throw std::exception();
-                }
-                if (activeSignature.contains(children[0]->lexeme)) {
-                    std::vector<wlp4Type> &signature = activeSignature[children[0]->lexeme];
-                    Node *arglist = children[2].get();
-                    if (arglist->compareArgs(signature, tables)) {
-                        type = wlp4Type::INT;
-                        return wlp4Type::INT;
-                    } else {
-                        throw std::exception();
-                    }
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "GETCHAR LPAREN RPAREN") {
-                type = wlp4Type::INT;
-                return wlp4Type::INT;
+            type = wlp4Type::INT;
+            return type;
+        case Typing::ADDRESS:
+            if (types[0] != wlp4Type::INT) {
+                return reject(node, context, "& needs an int lvalue, not " + getTypeString(types[0]));
             }
-        } else if (lhs == "lvalue") {
-            if (getRhsString() == "ID") {
-                wlp4Type idType = children[0]->fillType(tables);
-                if (idType != wlp4Type::UNKNOWN) {
-                    type = idType;
-                    return idType;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "STAR factor") {
-                Node *factor = children[1].get();
-                wlp4Type factorType = factor->fillType(tables);
-                if (factorType == wlp4Type::PTR) {
-                    type = wlp4Type::INT;
-                    return wlp4Type::INT;
-                } else {
-                    throw std::exception();
-                }
-            } else if (getRhsString() == "LPAREN lvalue RPAREN") {
-                type = children[1]->fillType(tables);
+            type = wlp4Type::PTR;
+            return type;
+        case Typing::DEREF:
+            // The type of a factor or lvalue deriving STAR factor is int. The type of the derived factor (i.e. the one preceded by STAR) must be int*.
+            if (types[0] != wlp4Type::PTR) {
+                return reject(node, context, "* needs an int*, not " + getTypeString(types[0]));
+            }
+            type = wlp4Type::INT;
+            return type;
+        case Typing::ALLOC:
+            if (types[0] != wlp4Type::INT) {
+                return reject(node, context, "new int[] needs an int size, not " + getTypeString(types[0]));
+            }
+            type = wlp4Type::PTR;
+            return type;
+        case Typing::CALL:
+        case Typing::CALL_ARGS: {
+            SymbolId callee = nodes.lexemes[nodes.child(node, 0)];
+            std::string name(symbols.name(callee));
+            // Only procedures declared before this one, or itself, are in scope.
+            int calleeSlot = context.tables.names.find(callee);
+            int calleeIndex = calleeSlot < 0 ? -1 : context.tables.procedureOf[calleeSlot];
+            if (context.procedure().variables.find(callee) >= 0) {
+                return reject(node, context, name + " is a variable, not a procedure");
+            }
+            if (calleeIndex < 0 || calleeIndex > context.scope) {
+                return reject(node, context, "procedure " + name + " is not declared before it is called");
+            }
+            const std::vector<wlp4Type> &signature = context.tables.procedures[calleeIndex].signature;
+            if (signature.size() != frame.visited) {
+                return reject(node, context, "procedure " + name + " takes " + std::to_string(signature.size()) +
+                                                 (signature.size() == 1 ? " argument, not " : " arguments, not ") +
+                                                 std::to_string(frame.visited));
+            }
+            if (std::find(types, types + frame.visited, wlp4Type::ERROR) != types + frame.visited) {
+                type = wlp4Type::ERROR;
                 return type;
             }
-        } else {
-            for (auto &child : children) {
-                child->fillType(tables);
+            if (!std::equal(signature.begin(), signature.end(), types)) {
+                return reject(node, context, "the arguments do not match the parameters of procedure " + name);
             }
-            return wlp4Type::UNKNOWN;
+            type = wlp4Type::INT;
+            return type;
+        }
+        case Typing::GETCHAR:
+            type = wlp4Type::INT;
+            return type;
+        case Typing::PROCEDURE:
+            if (types[2] != wlp4Type::INT) {
+                context.report("invalid type", node, "the return value is " + getTypeString(types[2]) + ", not int");
+            }
+            return type;
         }
         return type;
     }
-    void typeCheck(Tables &tables) {
-        fillType(tables);
+    // Reports a failed check on a node, which takes the error type.
+    wlp4Type reject(NodeId node, Context &context, std::string message) {
+        context.report("invalid type", node, std::move(message));
+        nodes.types[node] = wlp4Type::ERROR;
+        return wlp4Type::ERROR;
     }
-    void print() {
-        std::cout << lhs << " ";
-        if (lexeme != "") {
-            std::cout << lexeme;
-        } else {
-            std::cout << getRhsString();
-        }
-        if (type != wlp4Type::UNKNOWN) {
-            std::cout << " : " << getTypeString(type);
-        }
-        std::cout << std::endl;
-        for (auto &child : children) {
-            child->print();
+    // Types the subtree from an explicit stack of frames. The types of
+    // finished children wait on a second stack until their parent is done.
+    wlp4Type fillType(NodeId root, Context &context) {
+        std::vector<TypeFrame> frames{enterType(root, context)};
+        std::vector<wlp4Type> results;
+        while (!frames.empty()) {
+            TypeFrame &frame = frames.back();
+            NodeId child = nextChild(frame);
+            if (child != NO_NODE) {
+                TypeFrame childFrame = enterType(child, context);
+                childFrame.base = results.size();
+                frames.push_back(childFrame);
+                continue;
+            }
+            wlp4Type result = finishType(frame, results.data() + frame.base, context);
+            results.resize(frame.base);
+            frames.pop_back();
+            results.push_back(result);
         }
+        return results.back();
     }
-};
-
-class Tree {
-    std::unique_ptr<Node> root;
-    Tables tables = std::map<std::string, std::map<std::string, wlp4Type>>{{"wain", std::map<std::string, wlp4Type>{}}};
 
 public:
-    explicit Tree(std::istream &in) : root(std::make_unique<Node>("start")) {
-        root->populate(in);
+    explicit Tree(TextTreeReader &in) {
+        wellFormed = populate(in);
     }
-    void typeCheck() {
-        root->typeCheck(tables);
+    explicit Tree(TreeReader &in) {
+        wellFormed = populate(in) && in.ok();
     }
-    bool semanticCheck() {
-        return root->semanticCheck();
+    bool ok() const {
+        return wellFormed;
     }
+    // Declares every procedure and its parameters in one sequential pass
+    // down the procedures spine, then types and checks the bodies as tasks
+    // on up to `jobs` threads. A failed check does not stop the others; the
+    // diagnostics are returned in procedure order, then in the order each
+    // task found them, so they are the same for any `jobs`. Empty if the
+    // tree is a valid WLP4 program.
+    std::vector<Diagnostic> typeCheck(unsigned jobs) {
+        std::vector<NodeId> bodies;
+        std::vector<Context> contexts;
+        for (NodeId list = nodes.child(0, 1);; list = nodes.child(list, 1)) {
+            if (nodes.rules[list] == Production::PROCEDURES_MAIN) {
+                bodies.push_back(nodes.child(list, 0));
+                contexts.push_back(declareProcedure(WAIN_SCOPE, bodies.back(), NO_NODE));
+                break;
+            }
+            NodeId procedure = nodes.child(list, 0);
+            bodies.push_back(procedure);
+            contexts.push_back(declareProcedure(nodes.lexemes[nodes.child(procedure, 1)], procedure,
+                                                nodes.child(procedure, 3)));
+        }
+        std::atomic<size_t> next = 0;
+        auto work = [&] {
+            for (size_t k = next++; k < bodies.size(); k = next++) {
+                fillType(bodies[k], contexts[k]);
+                semanticCheck(bodies[k], contexts[k]);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < std::min<size_t>(jobs, bodies.size()); ++t) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (std::thread &t : threads) {
+            t.join();
+        }
+        std::vector<Diagnostic> diagnostics;
+        for (Context &context : contexts) {
+            std::move(context.diagnostics.begin(), context.diagnostics.end(), std::back_inserter(diagnostics));
+        }
+        return diagnostics;
+    }
+    // "<kind> in <procedure>: <message> [<index>: <node>]", where the node is
+    // named by its pre-order index and its production, or its token and
+    // lexeme.
+    std::string describe(const Diagnostic &diagnostic) const {
+        NodeId node = diagnostic.node;
+        std::string where = std::to_string(node) + ": ";
+        where += nodes.rules[node] != Production::NONE
+                                ? std::string(productionRule(nodes.rules[node]).text)
+                                : std::string(WLP4_CFG.names[nodes.leafCodes[node]]) + " " +
+                                      std::string(symbols.name(nodes.lexemes[node]));
+        return std::string(diagnostic.kind) + " in " + std::string(symbols.name(diagnostic.procedure)) + ": " +
+               diagnostic.message + " [" + where + "]";
+    }
+    // The nodes are stored in pre-order, which is the order both formats
+    // list them in.
     void print() {
-        root->print();
+        for (NodeId node = 0; node < nodes.size(); ++node) {
+            if (nodes.rules[node] != Production::NONE) {
+                std::cout << productionRule(nodes.rules[node]).text;
+            } else {
+                std::cout << WLP4_CFG.names[nodes.leafCodes[node]] << " " << symbols.name(nodes.lexemes[node]);
+            }
+            if (nodes.types[node] != wlp4Type::UNKNOWN) {
+                std::cout << " : " << getTypeString(nodes.types[node]);
+            }
+            std::cout << "\n";
+        }
+    }
+    void write(TreeWriter &out) {
+        for (NodeId node = 0; node < nodes.size(); ++node) {
+            if (nodes.rules[node] == Production::NONE) {
+                out.leaf(nodes.leafCodes[node], symbols.name(nodes.lexemes[node]), toTreeType(nodes.types[node]),
+                         nodes.slots[node]);
+            } else {
+                out.inner(static_cast<int>(nodes.rules[node]), toTreeType(nodes.types[node]));
+            }
+        }
     }
 };
 
-int main() {
-    Tree tree(std::cin);
-    try {
-        tree.typeCheck();
-    } catch (const std::exception &e) {
-        outputError("invalid type");
+// usage: wlp4type [--binary] [--jobs N]
+// --binary reads and writes the binary tree format in common/wlp4tree.h.
+// --jobs N checks the procedure bodies on N threads (0 picks one per
+// hardware thread).
+int main(int argc, char *argv[]) {
+    std::ios::sync_with_stdio(false);
+    bool binary = false;
+    unsigned jobs = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg(argv[i]);
+        if (arg == "--jobs" && !parseJobs(i + 1 < argc ? argv[++i] : nullptr, jobs)) {
+            outputError("invalid --jobs value");
+            return 1;
+        }
+        binary |= arg == "--binary";
+    }
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The text reader holds the whole input, which is not needed once the
+    // tree is built.
+    std::unique_ptr<Tree> tree;
+    if (binary) {
+        TreeReader reader(std::cin, symbols);
+        tree = std::make_unique<Tree>(reader);
+    } else {
+        TextTreeReader reader(STDIN_FILENO);
+        if (!reader.readable()) {
+            outputError("cannot read standard input");
+            return 1;
+        }
+        tree = std::make_unique<Tree>(reader);
+    }
+    if (!tree->ok()) {
+        outputError("malformed parse tree");
         return 0;
     }
-
-    if (!tree.semanticCheck()) {
-        outputError("semantic error");
+    std::vector<Diagnostic> diagnostics = tree->typeCheck(jobs);
+    for (const Diagnostic &diagnostic : diagnostics) {
+        outputError(tree->describe(diagnostic));
+    }
+    if (!diagnostics.empty()) {
         return 0;
     }
-    tree.print();
+    if (binary) {
+        TreeWriter writer(std::cout, productionTreeRules());
+        tree->write(writer);
+    } else {
+        tree->print();
+    }
 }